@@ -0,0 +1,44 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include <stdio.h>
+
+#include <common/int.h>
+#include <common/platform.h>
+
+#if defined(PLATFORM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/// Monotonic wall-clock time in seconds, for timing benchmark runs
+static inline double bench_now() {
+#if defined(PLATFORM_WINDOWS)
+    LARGE_INTEGER freq = {0};
+    LARGE_INTEGER count = {0};
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts = {0};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+#endif
+}
+
+// Each benchmark calls this to print one line of results, so all the output
+// lines up and it's easy to diff runs against each other.
+#define BENCH_REPORT(name, seconds, ops) printf("%-40s %10.3f ms %10.2f ns/op\n", (name), (seconds) * 1e3, ((seconds) * 1e9) / (double)(ops))
+
+// Keeps the compiler from optimizing away work whose result we never use
+static volatile u64 bench_sink;
+
+// Keeps a function out of line. Reference copies of old code kept in a
+// benchmark use this, so they pay for a call just like library functions do.
+#if defined(_MSC_VER)
+    #define BENCH_NOINLINE __declspec(noinline)
+#else
+    #define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+#endif // BENCH_H
@@ -0,0 +1,80 @@
+#include <stdlib.h>
+
+#include <common/int.h>
+#include <common/arena.h>
+
+#include "bench.h"
+
+enum {
+    /// Allocations per "frame", all freed together at the end of it
+    FRAME_ALLOCS = 10000,
+    FRAME_COUNT = 200,
+    /// Allocation sizes are picked from [1, MAX_ALLOC_SIZE]
+    MAX_ALLOC_SIZE = 256,
+};
+
+static u64 bench_rand(u64* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+void bench_arena() {
+    u64 sum = 0;
+    u32 sizes[FRAME_ALLOCS] = {0};
+    u64 seed = 0x9E3779B97F4A7C15;
+    for (u32 i = 0; i < FRAME_ALLOCS; i++) {
+        sizes[i] = (u32)(bench_rand(&seed) % MAX_ALLOC_SIZE) + 1;
+    }
+
+    // Small mixed-size temporaries, touched once, then all freed
+    void** ptrs = malloc(FRAME_ALLOCS * sizeof(void*));
+    double start = bench_now();
+    for (u32 frame = 0; frame < FRAME_COUNT; frame++) {
+        for (u32 i = 0; i < FRAME_ALLOCS; i++) {
+            u8* p = malloc(sizes[i]);
+            p[0] = (u8)i;
+            ptrs[i] = p;
+        }
+        for (u32 i = 0; i < FRAME_ALLOCS; i++) {
+            sum += *(u8*)ptrs[i];
+            free(ptrs[i]);
+        }
+    }
+    BENCH_REPORT("malloc + free (2M, 1-256 bytes)", bench_now() - start, FRAME_ALLOCS * FRAME_COUNT);
+
+    arena a = arena_create(64 * 1024 * 1024, 0);
+    start = bench_now();
+    for (u32 frame = 0; frame < FRAME_COUNT; frame++) {
+        for (u32 i = 0; i < FRAME_ALLOCS; i++) {
+            u8* p = arena_alloc(&a, sizes[i], ARENA_DEFAULT_ALIGNMENT);
+            p[0] = (u8)i;
+            ptrs[i] = p;
+        }
+        for (u32 i = 0; i < FRAME_ALLOCS; i++) {
+            sum += *(u8*)ptrs[i];
+        }
+        arena_reset(&a);
+    }
+    BENCH_REPORT("arena_alloc + reset (2M, 1-256 bytes)", bench_now() - start, FRAME_ALLOCS * FRAME_COUNT);
+
+    // Nested scratch space: each "task" frees its own allocations with a mark
+    start = bench_now();
+    for (u32 frame = 0; frame < FRAME_COUNT; frame++) {
+        for (u32 i = 0; i < FRAME_ALLOCS; i += 10) {
+            const arena_mark mark = arena_save(&a);
+            for (u32 j = i; j < i + 10; j++) {
+                u8* p = arena_alloc(&a, sizes[j], ARENA_DEFAULT_ALIGNMENT);
+                p[0] = (u8)j;
+                sum += p[0];
+            }
+            arena_restore(&a, mark);
+        }
+    }
+    BENCH_REPORT("arena_alloc + save/restore (2M)", bench_now() - start, FRAME_ALLOCS * FRAME_COUNT);
+    arena_destroy(&a);
+    free(ptrs);
+
+    bench_sink = sum;
+}
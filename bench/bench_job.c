@@ -0,0 +1,99 @@
+#include <stdio.h>
+
+#include <common/int.h>
+#include <common/job.h>
+#include <common/thread.h>
+
+#include "bench.h"
+
+enum {
+    FORK_JOIN_COUNT = 1000000,
+    THREAD_SPAWN_COUNT = 10000,
+    /// Jobs per group in the fork-join rounds
+    FORK_WIDTH = 64,
+    SCALING_COUNT = 1 << 24,
+};
+
+static void empty_job(void* arg) {
+    (void)arg;
+}
+
+static void empty_thread(void* arg) {
+    (void)arg;
+}
+
+/// Fork-join from inside a job, which goes through the worker's own deque
+static void fork_join_rounds(void* arg) {
+    (void)arg;
+    job_group group = {0};
+    for (u32 i = 0; i < FORK_JOIN_COUNT; i += FORK_WIDTH) {
+        for (u32 j = 0; j < FORK_WIDTH; j++) {
+            job_submit(&group, empty_job, NULL);
+        }
+        job_wait(&group);
+    }
+}
+
+/// Some arithmetic that's the same cost for every index
+static void scaling_kernel(void* arg, csize begin, csize end) {
+    (void)arg;
+    u64 sum = 0;
+    for (csize i = begin; i < end; i++) {
+        u64 x = i + 1;
+        for (u32 j = 0; j < 16; j++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        sum += x;
+    }
+    bench_sink += sum;
+}
+
+void bench_job() {
+    job_system_init(0);
+
+    // Per-task overhead, submitted from outside the pool (shared queue)
+    double start = bench_now();
+    job_group group = {0};
+    for (u32 i = 0; i < FORK_JOIN_COUNT; i += FORK_WIDTH) {
+        for (u32 j = 0; j < FORK_WIDTH; j++) {
+            job_submit(&group, empty_job, NULL);
+        }
+        job_wait(&group);
+    }
+    BENCH_REPORT("job fork-join x64, outside (1M)", bench_now() - start, FORK_JOIN_COUNT);
+
+    // Same thing from a worker thread, so jobs go through its deque
+    start = bench_now();
+    job_submit(&group, fork_join_rounds, NULL);
+    job_wait(&group);
+    BENCH_REPORT("job fork-join x64, in a job (1M)", bench_now() - start, FORK_JOIN_COUNT);
+
+    // The old way: a fresh thread per task
+    start = bench_now();
+    for (u32 i = 0; i < THREAD_SPAWN_COUNT; i++) {
+        thread t = {0};
+        thread_create(&t, empty_thread, NULL);
+        thread_join(t);
+    }
+    BENCH_REPORT("thread_create + join (10K)", bench_now() - start, THREAD_SPAWN_COUNT);
+    job_system_shutdown();
+
+    // Scaling from 1 thread up to every core. 1 thread is just a plain loop.
+    start = bench_now();
+    scaling_kernel(NULL, 0, SCALING_COUNT);
+    BENCH_REPORT("plain loop, 1 thread (16M)", bench_now() - start, SCALING_COUNT);
+    const u32 cpus = thread_cpu_count();
+    for (u32 threads = 2; threads < cpus * 2; threads *= 2) {
+        threads = MIN(threads, cpus);
+        // Workers plus the calling thread
+        job_system_init(threads - 1);
+        start = bench_now();
+        job_parallel_for(SCALING_COUNT, 0, scaling_kernel, NULL);
+        char name[64] = {0};
+        snprintf(name, sizeof(name), "parallel_for, %u threads (16M)", threads);
+        BENCH_REPORT(name, bench_now() - start, SCALING_COUNT);
+        job_system_shutdown();
+    }
+}
@@ -0,0 +1,72 @@
+#include <common/int.h>
+#include <common/list.h>
+#include <common/list_typed.h>
+
+#include "bench.h"
+
+static bool is_odd(const void* element, void* ctx) {
+    (void)ctx;
+    return (*(const u32*)element % 2) != 0;
+}
+
+void bench_list() {
+    const u32 count = 10000000;
+
+    // Appending one at a time, starting from a tiny buffer so we go through
+    // the whole chain of regrowth.
+    list l = list_create(16, sizeof(u32));
+    double start = bench_now();
+    for (u32 i = 0; i < count; i++) {
+        list_add(&l, &i);
+    }
+    BENCH_REPORT("list_add (10M u32)", bench_now() - start, count);
+
+    // Random-ish reads through list_get_element()
+    start = bench_now();
+    u64 sum = 0;
+    for (u32 i = 0; i < count; i++) {
+        sum += *(u32*)list_get_element(l, (i * 7919) % count);
+    }
+    bench_sink = sum;
+    BENCH_REPORT("list_get_element (10M u32)", bench_now() - start, count);
+
+    // Worst case search, where the value is never found
+    const u32 missing = UINT32_MAX;
+    const u32 searches = 20;
+    start = bench_now();
+    for (u32 i = 0; i < searches; i++) {
+        bench_sink = list_contains(l, &missing);
+    }
+    BENCH_REPORT("list_find miss (10M u32, per element)", bench_now() - start, (u64)searches * count);
+
+    // Merging a big list into an empty one
+    list dest = list_create(16, sizeof(u32));
+    start = bench_now();
+    list_merge(&dest, l);
+    BENCH_REPORT("list_merge (10M u32)", bench_now() - start, count);
+
+    // Filtering out half the list, keeping order
+    start = bench_now();
+    list_remove_if(&dest, is_odd, NULL);
+    BENCH_REPORT("list_remove_if half (10M u32)", bench_now() - start, count);
+
+    list_destroy(&dest);
+    list_destroy(&l);
+
+    // Same as the first two, but with a generated typed list
+    list_u32 typed = list_u32_create(4);
+    start = bench_now();
+    for (u32 i = 0; i < count; i++) {
+        list_u32_add(&typed, i);
+    }
+    BENCH_REPORT("list_u32_add (10M u32)", bench_now() - start, count);
+
+    start = bench_now();
+    sum = 0;
+    for (u32 i = 0; i < count; i++) {
+        sum += list_u32_get(typed, (i * 7919) % count);
+    }
+    bench_sink = sum;
+    BENCH_REPORT("list_u32_get (10M u32)", bench_now() - start, count);
+    list_u32_destroy(&typed);
+}
@@ -0,0 +1,78 @@
+#include <common/int.h>
+#include <common/list.h>
+#include <common/list_concurrent.h>
+#include <common/thread.h>
+
+#include "bench.h"
+
+enum {
+    MAX_PRODUCERS = 16,
+    TOTAL_ADDS = 4000000,
+};
+
+typedef struct {
+    list_concurrent* concurrent;
+    list* locked;
+    mutex* lock;
+    u32 adds;
+}producer_args;
+
+static void concurrent_producer(void* arg) {
+    producer_args* args = arg;
+    for (u32 i = 0; i < args->adds; i++) {
+        list_concurrent_add(args->concurrent, &i);
+    }
+}
+
+static void locked_producer(void* arg) {
+    producer_args* args = arg;
+    for (u32 i = 0; i < args->adds; i++) {
+        mutex_lock(args->lock);
+        list_add(args->locked, &i);
+        mutex_unlock(args->lock);
+    }
+}
+
+// Run the same total number of adds split across some number of threads
+static double run_producers(thread_proc proc, producer_args* args, u32 thread_count) {
+    thread threads[MAX_PRODUCERS] = {0};
+    const double start = bench_now();
+    for (u32 i = 0; i < thread_count; i++) {
+        thread_create(&threads[i], proc, args);
+    }
+    for (u32 i = 0; i < thread_count; i++) {
+        thread_join(threads[i]);
+    }
+    return bench_now() - start;
+}
+
+void bench_list_concurrent() {
+    // Always try a few thread counts, even on small machines, so we can see
+    // how badly the lock behaves under oversubscription.
+    const u32 max_threads = CLAMP(4, thread_cpu_count(), MAX_PRODUCERS);
+    char name[64] = {0};
+    for (u32 threads = 1; threads <= max_threads; threads *= 2) {
+        list_concurrent concurrent = list_concurrent_create(1024, sizeof(u32));
+        list locked = list_create(1024, sizeof(u32));
+        mutex lock = {0};
+        mutex_init(&lock);
+        producer_args args = {
+            .concurrent = &concurrent,
+            .locked = &locked,
+            .lock = &lock,
+            .adds = TOTAL_ADDS / threads,
+        };
+
+        double seconds = run_producers(locked_producer, &args, threads);
+        snprintf(name, sizeof(name), "mutex + list_add (%u threads)", threads);
+        BENCH_REPORT(name, seconds, TOTAL_ADDS);
+
+        seconds = run_producers(concurrent_producer, &args, threads);
+        snprintf(name, sizeof(name), "list_concurrent_add (%u threads)", threads);
+        BENCH_REPORT(name, seconds, TOTAL_ADDS);
+
+        mutex_destroy(&lock);
+        list_destroy(&locked);
+        list_concurrent_destroy(&concurrent);
+    }
+}
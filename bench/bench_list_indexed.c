@@ -0,0 +1,58 @@
+#include <common/int.h>
+#include <common/list.h>
+#include <common/list_indexed.h>
+
+#include "bench.h"
+
+static void bench_find(u32 count, u32 linear_lookups) {
+    list l = list_create(16, sizeof(u32));
+    list_indexed li = list_indexed_create(16, sizeof(u32));
+
+    double start = bench_now();
+    for (u32 i = 0; i < count; i++) {
+        list_add(&l, &i);
+    }
+    const double list_build = bench_now() - start;
+    start = bench_now();
+    for (u32 i = 0; i < count; i++) {
+        list_indexed_add(&li, &i);
+    }
+    const double indexed_build = bench_now() - start;
+
+    // Look up values spread across the whole list, so the linear scan goes
+    // through half the list on average.
+    char name[64] = {0};
+    start = bench_now();
+    u64 sum = 0;
+    for (u32 i = 0; i < linear_lookups; i++) {
+        const u32 val = (u32)(((u64)i * 2654435761) % count);
+        sum += list_find(l, &val);
+    }
+    bench_sink = sum;
+    snprintf(name, sizeof(name), "list_find (%u u32)", count);
+    BENCH_REPORT(name, bench_now() - start, linear_lookups);
+
+    const u32 indexed_lookups = 1000000;
+    start = bench_now();
+    for (u32 i = 0; i < indexed_lookups; i++) {
+        const u32 val = (u32)(((u64)i * 2654435761) % count);
+        sum += list_indexed_find(li, &val);
+    }
+    bench_sink = sum;
+    snprintf(name, sizeof(name), "list_indexed_find (%u u32)", count);
+    BENCH_REPORT(name, bench_now() - start, indexed_lookups);
+
+    snprintf(name, sizeof(name), "list_add (%u u32)", count);
+    BENCH_REPORT(name, list_build, count);
+    snprintf(name, sizeof(name), "list_indexed_add (%u u32)", count);
+    BENCH_REPORT(name, indexed_build, count);
+
+    list_indexed_destroy(&li);
+    list_destroy(&l);
+}
+
+void bench_list_indexed() {
+    bench_find(1000, 1000000);
+    bench_find(100000, 10000);
+    bench_find(10000000, 100);
+}
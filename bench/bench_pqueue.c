@@ -0,0 +1,80 @@
+#include <common/int.h>
+#include <common/list.h>
+#include <common/list_sort.h>
+#include <common/pqueue.h>
+
+#include "bench.h"
+
+enum {
+    HEAP_COUNT = 1000000,
+    RESORT_COUNT = 5000,
+};
+
+static u64 bench_rand(u64* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    const u64 x = *(const u64*)a;
+    const u64 y = *(const u64*)b;
+    return (x > y) - (x < y);
+}
+
+void bench_pqueue() {
+    u64 seed = 0x9E3779B97F4A7C15;
+    u64 sum = 0;
+
+    pqueue q = pqueue_create(HEAP_COUNT, 0);
+    double start = bench_now();
+    for (u32 i = 0; i < HEAP_COUNT; i++) {
+        pqueue_push(&q, bench_rand(&seed), NULL);
+    }
+    BENCH_REPORT("pqueue push (1M random u64)", bench_now() - start, HEAP_COUNT);
+
+    start = bench_now();
+    u64 key = 0;
+    while (pqueue_pop(&q, &key, NULL)) {
+        sum += key;
+    }
+    BENCH_REPORT("pqueue pop (1M)", bench_now() - start, HEAP_COUNT);
+
+    // Scheduler-style traffic: pop the next job, push a new one later on
+    for (u32 i = 0; i < 10000; i++) {
+        pqueue_push(&q, bench_rand(&seed) >> 16, NULL);
+    }
+    start = bench_now();
+    for (u32 i = 0; i < HEAP_COUNT; i++) {
+        pqueue_pop(&q, &key, NULL);
+        pqueue_push(&q, key + (bench_rand(&seed) >> 40), NULL);
+    }
+    sum += key;
+    BENCH_REPORT("pqueue pop + push @ 10K (1M)", bench_now() - start, HEAP_COUNT);
+    pqueue_destroy(&q);
+
+    // The old way: keep a sorted list & re-sort on every insert
+    list sorted = list_create(RESORT_COUNT * sizeof(u64), sizeof(u64));
+    start = bench_now();
+    for (u32 i = 0; i < RESORT_COUNT; i++) {
+        const u64 val = bench_rand(&seed);
+        list_add(&sorted, &val);
+        list_sort(&sorted, compare_u64);
+    }
+    sum += *(u64*)list_get_element(sorted, 0);
+    BENCH_REPORT("list_add + list_sort (5K)", bench_now() - start, RESORT_COUNT);
+
+    q = pqueue_create(RESORT_COUNT, 0);
+    start = bench_now();
+    for (u32 i = 0; i < RESORT_COUNT; i++) {
+        pqueue_push(&q, bench_rand(&seed), NULL);
+    }
+    pqueue_peek(q, &key);
+    sum += key;
+    BENCH_REPORT("pqueue push (5K)", bench_now() - start, RESORT_COUNT);
+    pqueue_destroy(&q);
+    list_destroy(&sorted);
+
+    bench_sink = sum;
+}
@@ -0,0 +1,149 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/int.h>
+#include <common/queue.h>
+
+#include "bench.h"
+
+// The old u64-only queue, which compacted with memmove() instead of wrapping
+// around. Kept here so the ring buffer has something to be compared against.
+// It's kept out of line, since the old queue lived in the library too.
+typedef struct {
+    u64* data;
+    csize alloc_size;
+    csize front_idx;
+    csize back_idx;
+}legacy_queue;
+
+static BENCH_NOINLINE void legacy_queue_add(legacy_queue* q, u64 val) {
+    const s64 maxidx = (s64)(q->alloc_size / sizeof(*q->data)) - 1;
+    if (maxidx < 0 || (s64)q->back_idx >= maxidx) {
+        if (q->front_idx != 0 && q->data != NULL) {
+            const csize size = (q->back_idx - q->front_idx) * sizeof(*q->data);
+            memmove(q->data, &q->data[q->front_idx], size);
+            memset(((u8*)q->data) + size, 0x00, q->alloc_size - size);
+            q->back_idx -= q->front_idx;
+            q->front_idx = 0;
+        }
+        else {
+            const csize newsize = ALIGN_UP(q->alloc_size + (q->alloc_size / 2), sizeof(*q->data));
+            void* newbuf = calloc(1, newsize);
+            memcpy(newbuf, q->data, q->alloc_size);
+            free(q->data);
+            q->data = newbuf;
+            q->alloc_size = newsize;
+        }
+    }
+    q->data[q->back_idx++] = val;
+}
+
+static BENCH_NOINLINE u64 legacy_queue_get(legacy_queue* q) {
+    const u64 val = q->data[q->front_idx++];
+    if (q->front_idx == q->back_idx) {
+        q->front_idx = 0;
+        q->back_idx = 0;
+    }
+    return val;
+}
+
+void bench_queue() {
+    const u32 count = 10000000;
+
+    // Fill up completely, then drain
+    queue q = queue_create(64, sizeof(u64));
+    double start = bench_now();
+    for (u64 i = 0; i < count; i++) {
+        queue_add(&q, &i);
+    }
+    u64 sum = 0;
+    u64 val = 0;
+    while (queue_get(&q, &val)) {
+        sum += val;
+    }
+    bench_sink = sum;
+    BENCH_REPORT("queue fill + drain (10M u64)", bench_now() - start, count);
+
+    // Steady state FIFO traffic, where the queue never gets very big
+    start = bench_now();
+    for (u64 i = 0; i < count; i++) {
+        queue_add(&q, &i);
+        queue_add(&q, &i);
+        queue_get(&q, &val);
+        sum += val;
+    }
+    bench_sink = sum;
+    BENCH_REPORT("queue add 2 / get 1 (10M)", bench_now() - start, count);
+
+    // Push/pop through a queue that stays at a fixed depth, which is where
+    // the old queue had to keep compacting
+    queue_destroy(&q);
+    q = queue_create(64, sizeof(u64));
+    for (u64 i = 0; i < 1024; i++) {
+        queue_add(&q, &i);
+    }
+    start = bench_now();
+    for (u64 i = 0; i < count; i++) {
+        queue_add(&q, &i);
+        queue_get(&q, &val);
+        sum += val;
+    }
+    bench_sink = sum;
+    BENCH_REPORT("queue push/pop @ depth 1024 (10M)", bench_now() - start, count);
+
+    // Work-list style traffic, pushing & popping hundreds at once
+    u64 batch[256] = {0};
+    start = bench_now();
+    for (u64 i = 0; i < count; i += ARRAY_SIZE(batch)) {
+        for (u64 j = 0; j < ARRAY_SIZE(batch); j++) {
+            batch[j] = i + j;
+        }
+        queue_add_many(&q, batch, ARRAY_SIZE(batch));
+        const csize got = queue_get_many(&q, batch, ARRAY_SIZE(batch));
+        for (csize j = 0; j < got; j++) {
+            sum += batch[j];
+        }
+    }
+    bench_sink = sum;
+    BENCH_REPORT("queue add_many/get_many 256 (10M)", bench_now() - start, count);
+
+    start = bench_now();
+    for (u64 i = 0; i < count; i += ARRAY_SIZE(batch)) {
+        for (u64 j = 0; j < ARRAY_SIZE(batch); j++) {
+            const u64 v = i + j;
+            queue_add(&q, &v);
+        }
+        for (u64 j = 0; j < ARRAY_SIZE(batch); j++) {
+            queue_get(&q, &val);
+            sum += val;
+        }
+    }
+    bench_sink = sum;
+    BENCH_REPORT("queue add/get x256 (10M)", bench_now() - start, count);
+    queue_destroy(&q);
+
+    legacy_queue old = { .data = calloc(1, 64), .alloc_size = 64 };
+    start = bench_now();
+    for (u64 i = 0; i < count; i++) {
+        legacy_queue_add(&old, i);
+    }
+    while (old.front_idx != old.back_idx) {
+        sum += legacy_queue_get(&old);
+    }
+    bench_sink = sum;
+    BENCH_REPORT("legacy fill + drain (10M u64)", bench_now() - start, count);
+
+    free(old.data);
+    old = (legacy_queue){ .data = calloc(1, 64), .alloc_size = 64 };
+    for (u64 i = 0; i < 1024; i++) {
+        legacy_queue_add(&old, i);
+    }
+    start = bench_now();
+    for (u64 i = 0; i < count; i++) {
+        legacy_queue_add(&old, i);
+        sum += legacy_queue_get(&old);
+    }
+    bench_sink = sum;
+    BENCH_REPORT("legacy push/pop @ depth 1024 (10M)", bench_now() - start, count);
+    free(old.data);
+}
@@ -0,0 +1,154 @@
+#include <time.h>
+
+#include <common/int.h>
+#include <common/queue.h>
+#include <common/queue_blocking.h>
+#include <common/thread.h>
+
+#include "bench.h"
+
+enum {
+    PINGPONG_COUNT = 20000,
+    /// Elements sent with a gap in between, so the consumer is idle most of the time
+    TRICKLE_COUNT = 200,
+    TRICKLE_GAP_MS = 1,
+};
+
+/// The baseline: a normal queue with a mutex & condition variable
+typedef struct {
+    queue q;
+    mutex lock;
+    cond nonempty;
+}cond_queue;
+
+static void cond_queue_push(cond_queue* q, const void* data) {
+    mutex_lock(&q->lock);
+    queue_add(&q->q, data);
+    mutex_unlock(&q->lock);
+    cond_signal(&q->nonempty);
+}
+
+static void cond_queue_pop(cond_queue* q, void* out) {
+    mutex_lock(&q->lock);
+    while (!queue_get(&q->q, out)) {
+        cond_wait(&q->nonempty, &q->lock, THREAD_WAIT_FOREVER);
+    }
+    mutex_unlock(&q->lock);
+}
+
+typedef enum {
+    WAIT_FUTEX,
+    WAIT_CONDVAR,
+    WAIT_SPIN,
+}wait_kind;
+
+typedef struct {
+    wait_kind kind;
+    queue_blocking blocking[2];
+    cond_queue conds[2];
+}wait_args;
+
+static void wait_push(wait_args* args, u32 which, u64 val) {
+    if (args->kind == WAIT_CONDVAR) {
+        cond_queue_push(&args->conds[which], &val);
+    }
+    else {
+        queue_blocking_push(&args->blocking[which], &val);
+    }
+}
+
+static u64 wait_pop(wait_args* args, u32 which) {
+    u64 val = 0;
+    if (args->kind == WAIT_CONDVAR) {
+        cond_queue_pop(&args->conds[which], &val);
+    }
+    else if (args->kind == WAIT_FUTEX) {
+        queue_blocking_pop(&args->blocking[which], &val, THREAD_WAIT_FOREVER);
+    }
+    else {
+        u32 spins = 0;
+        while (!queue_blocking_try_pop(&args->blocking[which], &val)) {
+            thread_backoff(&spins);
+        }
+    }
+    return val;
+}
+
+// Bounces every value straight back, for measuring wakeup latency
+static void echo(void* arg) {
+    wait_args* args = arg;
+    for (u32 i = 0; i < PINGPONG_COUNT; i++) {
+        wait_push(args, 1, wait_pop(args, 0));
+    }
+}
+
+// Just takes elements as they arrive
+static void drain(void* arg) {
+    wait_args* args = arg;
+    u64 sum = 0;
+    for (u32 i = 0; i < TRICKLE_COUNT; i++) {
+        sum += wait_pop(args, 0);
+    }
+    bench_sink = sum;
+}
+
+static void sleep_ms(u32 ms) {
+    const u64 end = thread_time_ms() + ms;
+    while (thread_time_ms() < end) {
+        // Sleep on a value that never changes, so only the timeout wakes us
+        _Atomic(u32) never = 0;
+        thread_wait(&never, 0, ms);
+    }
+}
+
+static void bench_wait_kind(wait_kind kind, const char* pingpong_name, const char* trickle_name) {
+    wait_args args = { .kind = kind };
+    for (u32 i = 0; i < 2; i++) {
+        queue_blocking_init(&args.blocking[i], 64 * sizeof(u64), sizeof(u64));
+        args.conds[i].q = queue_create(64 * sizeof(u64), sizeof(u64));
+        mutex_init(&args.conds[i].lock);
+        cond_init(&args.conds[i].nonempty);
+    }
+    thread t = {0};
+    u64 sum = 0;
+
+    // Round trips: every element wakes the other side up
+    double start = bench_now();
+    clock_t cpu = clock();
+    thread_create(&t, echo, &args);
+    for (u64 i = 0; i < PINGPONG_COUNT; i++) {
+        wait_push(&args, 0, i);
+        sum += wait_pop(&args, 1);
+    }
+    thread_join(t);
+    double elapsed = bench_now() - start;
+    BENCH_REPORT(pingpong_name, elapsed, PINGPONG_COUNT);
+    printf("%-40s %10.1f%% CPU\n", "", 100.0 * ((double)(clock() - cpu) / CLOCKS_PER_SEC) / elapsed);
+
+    // Mostly idle consumer: how much CPU does it burn while waiting?
+    start = bench_now();
+    cpu = clock();
+    thread_create(&t, drain, &args);
+    for (u64 i = 0; i < TRICKLE_COUNT; i++) {
+        sleep_ms(TRICKLE_GAP_MS);
+        wait_push(&args, 0, i);
+    }
+    thread_join(t);
+    elapsed = bench_now() - start;
+    BENCH_REPORT(trickle_name, elapsed, TRICKLE_COUNT);
+    printf("%-40s %10.1f%% CPU\n", "", 100.0 * ((double)(clock() - cpu) / CLOCKS_PER_SEC) / elapsed);
+    bench_sink += sum;
+
+    for (u32 i = 0; i < 2; i++) {
+        queue_blocking_destroy(&args.blocking[i]);
+        queue_destroy(&args.conds[i].q);
+        mutex_destroy(&args.conds[i].lock);
+        cond_destroy(&args.conds[i].nonempty);
+    }
+}
+
+void bench_queue_blocking() {
+    bench_wait_kind(WAIT_FUTEX, "queue_blocking round trip (20K)", "queue_blocking trickle 1ms (200)");
+    bench_wait_kind(WAIT_CONDVAR, "mutex + condvar round trip (20K)", "mutex + condvar trickle 1ms (200)");
+    bench_wait_kind(WAIT_SPIN, "spinning try_pop round trip (20K)", "spinning try_pop trickle 1ms (200)");
+}
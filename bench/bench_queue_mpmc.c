@@ -0,0 +1,110 @@
+#include <stdio.h>
+
+#include <common/int.h>
+#include <common/queue.h>
+#include <common/queue_mpmc.h>
+#include <common/thread.h>
+
+#include "bench.h"
+
+enum {
+    MAX_THREADS = 16,
+    TOTAL_HANDOFFS = 4000000,
+};
+
+typedef struct {
+    queue_mpmc* mpmc;
+    queue* locked;
+    mutex* lock;
+    u32 count;
+}contention_args;
+
+static void mpmc_producer(void* arg) {
+    contention_args* args = arg;
+    for (u64 i = 0; i < args->count; i++) {
+        queue_mpmc_push(args->mpmc, &i);
+    }
+}
+
+static void mpmc_consumer(void* arg) {
+    contention_args* args = arg;
+    u64 sum = 0;
+    for (u32 i = 0; i < args->count; i++) {
+        u64 val = 0;
+        queue_mpmc_pop(args->mpmc, &val);
+        sum += val;
+    }
+    bench_sink = sum;
+}
+
+static void locked_producer(void* arg) {
+    contention_args* args = arg;
+    for (u64 i = 0; i < args->count; i++) {
+        mutex_lock(args->lock);
+        queue_add(args->locked, &i);
+        mutex_unlock(args->lock);
+    }
+}
+
+static void locked_consumer(void* arg) {
+    contention_args* args = arg;
+    u64 sum = 0;
+    for (u32 i = 0; i < args->count;) {
+        u64 val = 0;
+        mutex_lock(args->lock);
+        const bool got = queue_get(args->locked, &val);
+        mutex_unlock(args->lock);
+        if (!got) {
+            thread_yield();
+            continue;
+        }
+        sum += val;
+        i++;
+    }
+    bench_sink = sum;
+}
+
+// Run the same total number of handoffs between N producers & N consumers
+static double run_pairs(thread_proc producer, thread_proc consumer, contention_args* args, u32 pairs) {
+    thread threads[MAX_THREADS * 2] = {0};
+    const double start = bench_now();
+    for (u32 i = 0; i < pairs; i++) {
+        thread_create(&threads[i * 2], producer, args);
+        thread_create(&threads[(i * 2) + 1], consumer, args);
+    }
+    for (u32 i = 0; i < pairs * 2; i++) {
+        thread_join(threads[i]);
+    }
+    return bench_now() - start;
+}
+
+void bench_queue_mpmc() {
+    // Always try a few thread counts, even on small machines, so we can see
+    // how badly the lock behaves under oversubscription.
+    const u32 max_pairs = CLAMP(4, thread_cpu_count() / 2, MAX_THREADS);
+    char name[64] = {0};
+    for (u32 pairs = 1; pairs <= max_pairs; pairs *= 2) {
+        queue_mpmc mpmc = queue_mpmc_create(1024, sizeof(u64));
+        queue locked = queue_create(1024 * sizeof(u64), sizeof(u64));
+        mutex lock = {0};
+        mutex_init(&lock);
+        contention_args args = {
+            .mpmc = &mpmc,
+            .locked = &locked,
+            .lock = &lock,
+            .count = TOTAL_HANDOFFS / pairs,
+        };
+
+        double seconds = run_pairs(locked_producer, locked_consumer, &args, pairs);
+        snprintf(name, sizeof(name), "mutex + queue (%ux%u threads)", pairs, pairs);
+        BENCH_REPORT(name, seconds, TOTAL_HANDOFFS);
+
+        seconds = run_pairs(mpmc_producer, mpmc_consumer, &args, pairs);
+        snprintf(name, sizeof(name), "queue_mpmc (%ux%u threads)", pairs, pairs);
+        BENCH_REPORT(name, seconds, TOTAL_HANDOFFS);
+
+        mutex_destroy(&lock);
+        queue_destroy(&locked);
+        queue_mpmc_destroy(&mpmc);
+    }
+}
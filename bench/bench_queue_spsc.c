@@ -0,0 +1,158 @@
+#include <common/int.h>
+#include <common/queue.h>
+#include <common/queue_spsc.h>
+#include <common/thread.h>
+
+#include "bench.h"
+
+enum {
+    HANDOFF_COUNT = 10000000,
+    PINGPONG_COUNT = 100000,
+    BATCH_SIZE = 64,
+};
+
+typedef struct {
+    queue_spsc* spsc;
+    queue_spsc* reply;
+    queue* locked;
+    mutex* lock;
+}handoff_args;
+
+static void spsc_producer(void* arg) {
+    handoff_args* args = arg;
+    for (u64 i = 0; i < HANDOFF_COUNT; i++) {
+        u32 spins = 0;
+        while (!queue_spsc_push(args->spsc, &i)) {
+            thread_backoff(&spins);
+        }
+    }
+}
+
+static void spsc_batch_producer(void* arg) {
+    handoff_args* args = arg;
+    u64 batch[BATCH_SIZE] = {0};
+    for (u64 i = 0; i < HANDOFF_COUNT; i += BATCH_SIZE) {
+        for (u64 j = 0; j < BATCH_SIZE; j++) {
+            batch[j] = i + j;
+        }
+        csize sent = 0;
+        u32 spins = 0;
+        while (sent < BATCH_SIZE) {
+            const csize n = queue_spsc_push_many(args->spsc, batch + sent, BATCH_SIZE - sent);
+            if (n == 0) {
+                thread_backoff(&spins);
+            }
+            sent += n;
+        }
+    }
+}
+
+static void locked_producer(void* arg) {
+    handoff_args* args = arg;
+    for (u64 i = 0; i < HANDOFF_COUNT; i++) {
+        mutex_lock(args->lock);
+        queue_add(args->locked, &i);
+        mutex_unlock(args->lock);
+    }
+}
+
+// Bounces every value straight back, for measuring round trip latency
+static void echo(void* arg) {
+    handoff_args* args = arg;
+    for (u32 i = 0; i < PINGPONG_COUNT; i++) {
+        u64 val = 0;
+        u32 spins = 0;
+        while (!queue_spsc_pop(args->spsc, &val)) {
+            thread_backoff(&spins);
+        }
+        spins = 0;
+        while (!queue_spsc_push(args->reply, &val)) {
+            thread_backoff(&spins);
+        }
+    }
+}
+
+void bench_queue_spsc() {
+    queue_spsc spsc = queue_spsc_create(1024, sizeof(u64));
+    queue_spsc reply = queue_spsc_create(1024, sizeof(u64));
+    queue locked = queue_create(1024 * sizeof(u64), sizeof(u64));
+    mutex lock = {0};
+    mutex_init(&lock);
+    handoff_args args = { .spsc = &spsc, .reply = &reply, .locked = &locked, .lock = &lock };
+    thread t = {0};
+    u64 sum = 0;
+
+    // Throughput, one element at a time
+    double start = bench_now();
+    thread_create(&t, spsc_producer, &args);
+    for (u64 received = 0; received < HANDOFF_COUNT;) {
+        u64 val = 0;
+        u32 spins = 0;
+        while (!queue_spsc_pop(&spsc, &val)) {
+            thread_backoff(&spins);
+        }
+        sum += val;
+        received++;
+    }
+    thread_join(t);
+    BENCH_REPORT("queue_spsc push/pop (10M handoffs)", bench_now() - start, HANDOFF_COUNT);
+
+    // Throughput in batches
+    start = bench_now();
+    thread_create(&t, spsc_batch_producer, &args);
+    for (u64 received = 0; received < HANDOFF_COUNT;) {
+        u64 batch[BATCH_SIZE] = {0};
+        const csize n = queue_spsc_pop_many(&spsc, batch, BATCH_SIZE);
+        if (n == 0) {
+            thread_yield();
+        }
+        for (csize i = 0; i < n; i++) {
+            sum += batch[i];
+        }
+        received += n;
+    }
+    thread_join(t);
+    BENCH_REPORT("queue_spsc batch 64 (10M handoffs)", bench_now() - start, HANDOFF_COUNT);
+
+    // The old way: a normal queue behind a mutex
+    start = bench_now();
+    thread_create(&t, locked_producer, &args);
+    for (u64 received = 0; received < HANDOFF_COUNT;) {
+        u64 val = 0;
+        mutex_lock(&lock);
+        const bool got = queue_get(&locked, &val);
+        mutex_unlock(&lock);
+        if (!got) {
+            thread_yield();
+            continue;
+        }
+        sum += val;
+        received++;
+    }
+    thread_join(t);
+    BENCH_REPORT("mutex + queue (10M handoffs)", bench_now() - start, HANDOFF_COUNT);
+
+    // Round trip latency
+    start = bench_now();
+    thread_create(&t, echo, &args);
+    for (u64 i = 0; i < PINGPONG_COUNT; i++) {
+        u32 spins = 0;
+        while (!queue_spsc_push(&spsc, &i)) {
+            thread_backoff(&spins);
+        }
+        u64 val = 0;
+        spins = 0;
+        while (!queue_spsc_pop(&reply, &val)) {
+            thread_backoff(&spins);
+        }
+        sum += val;
+    }
+    thread_join(t);
+    BENCH_REPORT("queue_spsc round trip (100K)", bench_now() - start, PINGPONG_COUNT);
+    bench_sink = sum;
+
+    mutex_destroy(&lock);
+    queue_destroy(&locked);
+    queue_spsc_destroy(&reply);
+    queue_spsc_destroy(&spsc);
+}
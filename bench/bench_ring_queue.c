@@ -0,0 +1,49 @@
+#include <common/int.h>
+#include <common/queue.h>
+#include <common/ring_queue.h>
+
+#include "bench.h"
+
+void bench_ring_queue() {
+    const u32 count = 10000000;
+    const u32 batch_size = 256;
+    u64 batch[256] = {0};
+
+    // Producer writes a batch, consumer processes it in place
+    ring_queue r = ring_queue_create(64 * 1024, sizeof(u64));
+    u64 sum = 0;
+    double start = bench_now();
+    for (u32 i = 0; i < count; i += batch_size) {
+        for (u32 j = 0; j < batch_size; j++) {
+            batch[j] = i + j;
+        }
+        ring_queue_add_many(&r, batch, batch_size);
+
+        csize n = 0;
+        const u64* span = ring_queue_peek_span(r, &n);
+        for (csize j = 0; j < n; j++) {
+            sum += span[j];
+        }
+        ring_queue_consume(&r, n);
+    }
+    bench_sink = sum;
+    BENCH_REPORT("ring_queue batch 256 + peek_span (10M)", bench_now() - start, count);
+    ring_queue_destroy(&r);
+
+    // Same traffic through the normal queue, one element at a time
+    queue q = queue_create(64 * 1024, sizeof(u64));
+    start = bench_now();
+    for (u32 i = 0; i < count; i += batch_size) {
+        for (u64 j = 0; j < batch_size; j++) {
+            const u64 val = i + j;
+            queue_add(&q, &val);
+        }
+        u64 val = 0;
+        while (queue_get(&q, &val)) {
+            sum += val;
+        }
+    }
+    bench_sink = sum;
+    BENCH_REPORT("queue batch 256, 1 at a time (10M)", bench_now() - start, count);
+    queue_destroy(&q);
+}
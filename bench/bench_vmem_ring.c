@@ -0,0 +1,105 @@
+#include <string.h>
+
+#include <common/int.h>
+#include <common/queue_spsc.h>
+#include <common/thread.h>
+#include <common/vmem_ring.h>
+
+#include "bench.h"
+
+enum {
+    /// Bytes streamed from the producer to the consumer
+    STREAM_BYTES = 256 * 1024 * 1024,
+    RING_SIZE = 64 * 1024,
+    /// Bytes handed over at a time, like a read() from a file or socket
+    CHUNK_SIZE = 4096,
+};
+
+/// Stand-in for reading from a file: fill a block with bytes
+static void fill_chunk(u8* dst, csize size, u64 offset) {
+    for (csize i = 0; i < size; i += sizeof(u64)) {
+        const u64 val = offset + i;
+        memcpy(dst + i, &val, sizeof(val));
+    }
+}
+
+/// Stand-in for parsing: sum a block as u64s
+static u64 parse_chunk(const u8* src, csize size) {
+    u64 sum = 0;
+    for (csize i = 0; i + sizeof(u64) <= size; i += sizeof(u64)) {
+        u64 val = 0;
+        memcpy(&val, src + i, sizeof(val));
+        sum += val;
+    }
+    return sum;
+}
+
+static void ring_producer(void* arg) {
+    vmem_ring* r = arg;
+    for (u64 offset = 0; offset < STREAM_BYTES; offset += CHUNK_SIZE) {
+        vmem_ring_write_wait(r, CHUNK_SIZE, THREAD_WAIT_FOREVER);
+        fill_chunk(vmem_ring_write_reserve(r, CHUNK_SIZE), CHUNK_SIZE, offset);
+        vmem_ring_write_commit(r, CHUNK_SIZE);
+    }
+    vmem_ring_close(r);
+}
+
+static void spsc_producer(void* arg) {
+    queue_spsc* q = arg;
+    u8 chunk[CHUNK_SIZE];
+    for (u64 offset = 0; offset < STREAM_BYTES; offset += CHUNK_SIZE) {
+        fill_chunk(chunk, CHUNK_SIZE, offset);
+        csize sent = 0;
+        u32 spins = 0;
+        while (sent < CHUNK_SIZE) {
+            const csize n = queue_spsc_push_many(q, chunk + sent, CHUNK_SIZE - sent);
+            if (n == 0) {
+                thread_backoff(&spins);
+            }
+            sent += n;
+        }
+    }
+}
+
+void bench_vmem_ring() {
+    u64 sum = 0;
+
+    // Zero-copy: the producer fills the ring directly & the consumer parses in place
+    vmem_ring r = vmem_ring_create(RING_SIZE);
+    thread producer = {0};
+    double start = bench_now();
+    thread_create(&producer, ring_producer, &r);
+    while (vmem_ring_read_wait(&r, 1, THREAD_WAIT_FOREVER)) {
+        csize available = 0;
+        const u8* src = vmem_ring_read_peek(&r, &available);
+        sum += parse_chunk(src, available);
+        vmem_ring_read_consume(&r, available);
+    }
+    thread_join(producer);
+    BENCH_REPORT("vmem_ring zero-copy stream (256MB, bytes)", bench_now() - start, STREAM_BYTES);
+    vmem_ring_destroy(&r);
+
+    // The copying way: a byte queue, with a staging buffer on each side
+    queue_spsc q = queue_spsc_create(RING_SIZE, 1);
+    u8 chunk[CHUNK_SIZE];
+    start = bench_now();
+    thread_create(&producer, spsc_producer, &q);
+    for (u64 received = 0; received < STREAM_BYTES; received += CHUNK_SIZE) {
+        // Gather a whole chunk first, since records can't be parsed in pieces
+        csize got = 0;
+        u32 spins = 0;
+        while (got < CHUNK_SIZE) {
+            const csize n = queue_spsc_pop_many(&q, chunk + got, CHUNK_SIZE - got);
+            if (n == 0) {
+                thread_backoff(&spins);
+            }
+            got += n;
+        }
+        sum += parse_chunk(chunk, CHUNK_SIZE);
+    }
+    thread_join(producer);
+    BENCH_REPORT("queue_spsc copy in & out (256MB, bytes)", bench_now() - start, STREAM_BYTES);
+    queue_spsc_destroy(&q);
+
+    bench_sink = sum;
+}
@@ -0,0 +1,45 @@
+#include <stdio.h>
+
+#include <common/int.h>
+#include <common/logging.h>
+
+void bench_list();
+void bench_list_indexed();
+void bench_list_concurrent();
+void bench_queue();
+void bench_ring_queue();
+void bench_queue_spsc();
+void bench_queue_mpmc();
+void bench_pqueue();
+void bench_queue_blocking();
+void bench_job();
+void bench_vmem_ring();
+void bench_arena();
+
+typedef void (*benchproc)(void);
+benchproc benchmarks[] = {
+    bench_list,
+    bench_list_indexed,
+    bench_list_concurrent,
+    bench_queue,
+    bench_ring_queue,
+    bench_queue_spsc,
+    bench_queue_mpmc,
+    bench_pqueue,
+    bench_queue_blocking,
+    bench_job,
+    bench_vmem_ring,
+    bench_arena,
+};
+
+int main() {
+    enable_win_ansi();
+
+    // Results depend heavily on this, so always print it
+    LOG_MSG(info, "Running %d benchmarks with %d-bit container sizes\n", ARRAY_SIZE(benchmarks), (int)(sizeof(csize) * 8));
+    for (u32 i = 0; i < ARRAY_SIZE(benchmarks); i++) {
+        benchmarks[i]();
+    }
+
+    return 0;
+}
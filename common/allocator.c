@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocator.h"
+
+static void* heap_alloc(void* ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void* heap_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    (void)ctx;
+    (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+static void heap_free(void* ctx, void* ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+const allocator allocator_heap = {
+    .alloc = heap_alloc,
+    .realloc = heap_realloc,
+    .free = heap_free,
+};
+
+static const allocator* default_allocator = &allocator_heap;
+
+const allocator* allocator_default(void) {
+    return default_allocator;
+}
+
+void allocator_set_default(const allocator* a) {
+    default_allocator = (a != NULL) ? a : &allocator_heap;
+}
+
+void* allocator_alloc(const allocator* a, size_t size) {
+    a = (a != NULL) ? a : default_allocator;
+    return a->alloc(a->ctx, size);
+}
+
+void* allocator_calloc(const allocator* a, size_t size) {
+    void* out = allocator_alloc(a, size);
+    if (out != NULL) {
+        memset(out, 0x00, size);
+    }
+    return out;
+}
+
+void* allocator_realloc(const allocator* a, void* ptr, size_t old_size, size_t new_size) {
+    a = (a != NULL) ? a : default_allocator;
+    if (ptr == NULL) {
+        return a->alloc(a->ctx, new_size);
+    }
+    if (a->realloc != NULL) {
+        return a->realloc(a->ctx, ptr, old_size, new_size);
+    }
+
+    // No realloc callback, so fall back to alloc + copy + free
+    void* out = a->alloc(a->ctx, new_size);
+    if (out == NULL) {
+        return NULL;
+    }
+    memcpy(out, ptr, (old_size < new_size) ? old_size : new_size);
+    if (a->free != NULL) {
+        a->free(a->ctx, ptr);
+    }
+    return out;
+}
+
+void allocator_free(const allocator* a, void* ptr) {
+    a = (a != NULL) ? a : default_allocator;
+    if (a->free != NULL && ptr != NULL) {
+        a->free(a->ctx, ptr);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+/// @file allocator.h
+/// @brief Pluggable memory allocator interface
+///
+/// Containers like @ref list and @ref queue (and helpers like file_load())
+/// get their memory through an @ref allocator instead of calling
+/// malloc()/free() directly. That way they can be put on arenas, pools, or
+/// tracking allocators that attribute bytes to a subsystem.
+///
+/// Anywhere an allocator pointer is accepted, NULL means the library-wide
+/// default (see @ref allocator_set_default()), which starts out as the C heap.
+/// Containers look up the default once when they're created and keep using
+/// that allocator, so changing the default never mixes up who frees what.
+
+#include <stddef.h>
+
+/// @brief Allocator vtable
+///
+/// All callbacks get @ref allocator.ctx as their first argument, so one set
+/// of functions can serve many arenas/pools/trackers.
+typedef struct {
+    /// @brief Allocate @p size bytes. The contents don't need to be zeroed.
+    /// @return Pointer to the block, or NULL on failure
+    void* (*alloc)(void* ctx, size_t size);
+    /// @brief Resize a block, moving it if needed.
+    ///
+    /// @p old_size is the size it was allocated with, so allocators that
+    /// can't resize in place (like bump allocators) know how much to copy.
+    /// @return Pointer to the resized block, or NULL on failure (in which
+    /// case the old block is left untouched)
+    /// @note Can be NULL, then @ref allocator_realloc() falls back to
+    /// alloc + copy + free.
+    void* (*realloc)(void* ctx, void* ptr, size_t old_size, size_t new_size);
+    /// @brief Free a block. Must accept NULL. Can be NULL for allocators that
+    /// only ever free everything at once (like arenas).
+    void (*free)(void* ctx, void* ptr);
+    /// User data passed to every callback
+    void* ctx;
+}allocator;
+
+/// Allocator backed by malloc()/realloc()/free()
+extern const allocator allocator_heap;
+
+/// @brief Get the library-wide default allocator.
+/// @return The default allocator, never NULL
+const allocator* allocator_default(void);
+
+/// @brief Change the library-wide default allocator.
+/// @param a The new default, or NULL to go back to @ref allocator_heap. This
+/// isn't copied, so it has to stay valid as long as anything uses it.
+/// @warning This isn't synchronized, set it up before starting any threads.
+void allocator_set_default(const allocator* a);
+
+/// Allocate @p size bytes from @p a (NULL for the default)
+void* allocator_alloc(const allocator* a, size_t size);
+
+/// Allocate @p size bytes from @p a (NULL for the default), filled with 0
+void* allocator_calloc(const allocator* a, size_t size);
+
+/// @brief Resize a block from @p a (NULL for the default). See
+/// @ref allocator.realloc.
+void* allocator_realloc(const allocator* a, void* ptr, size_t old_size, size_t new_size);
+
+/// Free a block from @p a (NULL for the default)
+void allocator_free(const allocator* a, void* ptr);
+
+#endif // #ifndef ALLOCATOR_H
@@ -0,0 +1,137 @@
+#include <string.h>
+
+#include "int.h"
+#include "logging.h"
+#include "vmem.h"
+#include "arena.h"
+
+/// Round @p x up to a multiple of @p bound. Unlike ALIGN_UP(), values that
+/// are already aligned stay the same.
+static inline u64 arena_round_up(u64 x, u64 bound) {
+    return ((x + bound - 1) / bound) * bound;
+}
+
+/// @ref arena_round_up() for when @p bound is a power of 2
+static inline u64 arena_align_up(u64 x, u64 bound) {
+    return (x + bound - 1) & ~(bound - 1);
+}
+
+static inline bool is_pow2(u64 x) {
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
+arena arena_create(u64 reserve_size, u64 commit_chunk) {
+    if (commit_chunk == 0) {
+        commit_chunk = ARENA_DEFAULT_COMMIT_CHUNK;
+    }
+    commit_chunk = arena_round_up(commit_chunk, VMEM_PAGE_SIZE);
+    // Whole chunks, so committing never has to stop partway through one
+    reserve_size = arena_round_up(MAX(reserve_size, 1), commit_chunk);
+
+    u8* base = vmem_reserve(reserve_size);
+    if (base == NULL) {
+        LOG_MSG(error, "Failed to reserve 0x%llX bytes\n", (unsigned long long)reserve_size);
+        return (arena){0};
+    }
+    return (arena){
+        .base = base,
+        .reserved = reserve_size,
+        .commit_chunk = commit_chunk,
+    };
+}
+
+void arena_destroy(arena* a) {
+    if (a->base != NULL) {
+        vmem_free(a->base, a->reserved);
+    }
+    *a = (arena){0};
+}
+
+/// Make sure everything up to @p end is committed
+static bool arena_commit_to(arena* a, u64 end) {
+    if (end <= a->committed) {
+        return true;
+    }
+    const u64 target = MIN(arena_round_up(end, a->commit_chunk), a->reserved);
+    if (vmem_commit(a->base + a->committed, target - a->committed) != 0) {
+        LOG_MSG(error, "Failed to commit 0x%llX bytes\n", (unsigned long long)(target - a->committed));
+        return false;
+    }
+    a->committed = target;
+    return true;
+}
+
+void* arena_alloc(arena* a, u64 size, u64 alignment) {
+    if (!is_pow2(alignment)) {
+        LOG_MSG(error, "Alignment 0x%llX isn't a power of 2\n", (unsigned long long)alignment);
+        return NULL;
+    }
+    // Align the address, not the offset, in case alignment > the base's
+    const uintptr_t addr = (uintptr_t)(a->base + a->pos);
+    const u64 start = a->pos + (arena_align_up(addr, alignment) - addr);
+    if (start > a->reserved || size > a->reserved - start) {
+        LOG_MSG(error, "Arena is full, can't fit 0x%llX bytes\n", (unsigned long long)size);
+        return NULL;
+    }
+    if (!arena_commit_to(a, start + size)) {
+        return NULL;
+    }
+    a->last = start;
+    a->pos = start + size;
+    return a->base + start;
+}
+
+arena_mark arena_save(const arena* a) {
+    return (arena_mark){ .pos = a->pos, .last = a->last };
+}
+
+void arena_restore(arena* a, arena_mark mark) {
+    if (mark.pos > a->pos) {
+        LOG_MSG(error, "Mark 0x%llX is past the end of the arena\n", (unsigned long long)mark.pos);
+        return;
+    }
+    a->pos = mark.pos;
+    a->last = mark.last;
+}
+
+void arena_reset(arena* a) {
+    a->pos = 0;
+    a->last = 0;
+}
+
+static void* arena_vtable_alloc(void* ctx, size_t size) {
+    return arena_alloc(ctx, size, ARENA_DEFAULT_ALIGNMENT);
+}
+
+static void* arena_vtable_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    arena* a = ctx;
+    if (ptr == NULL) {
+        return arena_alloc(a, new_size, ARENA_DEFAULT_ALIGNMENT);
+    }
+    // The newest block can just grow or shrink in place
+    if ((u8*)ptr == a->base + a->last && a->pos == a->last + old_size) {
+        if (new_size > a->reserved - a->last || !arena_commit_to(a, a->last + new_size)) {
+            return NULL;
+        }
+        a->pos = a->last + new_size;
+        return ptr;
+    }
+    if (new_size <= old_size) {
+        return ptr;
+    }
+    void* new_ptr = arena_alloc(a, new_size, ARENA_DEFAULT_ALIGNMENT);
+    if (new_ptr != NULL) {
+        memcpy(new_ptr, ptr, old_size);
+    }
+    return new_ptr;
+}
+
+allocator arena_allocator(arena* a) {
+    return (allocator){
+        .alloc = arena_vtable_alloc,
+        .realloc = arena_vtable_realloc,
+        // Memory only goes back all at once
+        .free = NULL,
+        .ctx = a,
+    };
+}
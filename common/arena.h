@@ -0,0 +1,100 @@
+#ifndef ARENA_H
+#define ARENA_H
+/// @file arena.h
+/// @brief Linear (bump) allocator on reserved virtual memory
+///
+/// An arena reserves one big range of address space up front with
+/// @ref vmem_reserve(), then hands out memory by moving a cursor forward.
+/// Physical memory is committed in chunks as the cursor reaches it, so a
+/// huge reservation only costs what's actually used, and the arena never
+/// moves (pointers into it stay valid until it's reset or destroyed).
+///
+/// There's no per-allocation free. Instead, everything is freed at once with
+/// @ref arena_reset(), or back to an earlier point with
+/// @ref arena_save() & @ref arena_restore(). Both are O(1), which makes
+/// arenas a good fit for per-frame or per-task temporary memory.
+///
+/// @ref arena_allocator() wraps an arena in an @ref allocator, so containers
+/// & helpers that take one can allocate from it.
+///
+/// @warning Arenas aren't thread-safe.
+/// @sa vmem.h, allocator.h
+
+#include <stdbool.h>
+
+#include "int.h"
+#include "allocator.h"
+
+enum {
+    /// Default amount of memory committed at a time
+    ARENA_DEFAULT_COMMIT_CHUNK = 64 * 1024,
+    /// Alignment used by @ref arena_allocator(), enough for any basic type
+    ARENA_DEFAULT_ALIGNMENT = 16,
+};
+
+/// @brief A linear allocator on a reserved address range
+typedef struct {
+    /// Start of the reserved range
+    u8* base;
+    /// Size of the reserved range
+    u64 reserved;
+    /// Bytes at the start of the range that have been committed
+    u64 committed;
+    /// Offset of the next free byte
+    u64 pos;
+    /// Amount of memory committed at a time. A multiple of the page size.
+    u64 commit_chunk;
+    /// Offset of the most recent allocation, so it can be resized in place
+    u64 last;
+}arena;
+
+/// @brief A saved arena position. See @ref arena_save().
+typedef struct {
+    u64 pos;
+    u64 last;
+}arena_mark;
+
+/// @brief Reserve address space for an arena. Nothing is committed yet.
+/// @param reserve_size Max total size of everything in the arena. This can
+/// be much bigger than physical memory, since only what's used gets
+/// committed.
+/// @param commit_chunk How much memory to commit at a time, rounded up to
+/// the page size. 0 means @ref ARENA_DEFAULT_COMMIT_CHUNK. Bigger chunks make
+/// fewer system calls, smaller ones waste less memory.
+/// @return A new arena, with a NULL @ref arena.base on failure.
+/// @sa arena_destroy
+arena arena_create(u64 reserve_size, u64 commit_chunk);
+
+/// @brief Free the whole reserved range & fill all fields with 0.
+void arena_destroy(arena* a);
+
+/// @brief Allocate a block from the arena.
+/// @param a The arena
+/// @param size Size of the block. The contents aren't zeroed.
+/// @param alignment Alignment of the block, which has to be a power of 2.
+/// @return Pointer to the block, or NULL if the arena is full (or the memory
+/// couldn't be committed)
+void* arena_alloc(arena* a, u64 size, u64 alignment);
+
+/// @brief Save the arena's current position.
+/// @sa arena_restore
+arena_mark arena_save(const arena* a);
+
+/// @brief Free everything allocated since @p mark was saved.
+///
+/// The memory stays committed, so it's reused without any system calls.
+/// @warning Marks have to be restored in the reverse order they were saved,
+/// and can't be used after an earlier mark is restored or the arena is reset.
+void arena_restore(arena* a, arena_mark mark);
+
+/// @brief Free everything in the arena. The memory stays committed.
+void arena_reset(arena* a);
+
+/// @brief Make an @ref allocator that allocates from @p a.
+///
+/// Blocks are aligned to @ref ARENA_DEFAULT_ALIGNMENT. Freeing does nothing,
+/// and resizing the most recent block happens in place. The allocator points
+/// to @p a, so the arena can't move while it's in use.
+allocator arena_allocator(arena* a);
+
+#endif // #ifndef ARENA_H
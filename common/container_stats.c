@@ -0,0 +1,19 @@
+#include <stdbool.h>
+
+#include "int.h"
+#include "logging.h"
+#include "container_stats.h"
+
+bool container_stats_enabled() {
+#ifdef BOBTAIL_CONTAINER_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void container_stats_print(const char* name, container_stats stats) {
+    LOG_MSG(info, "%s: %u grows, 0x%llX bytes copied, 0x%llX bytes compacted, peak %llu elements / 0x%llX bytes, suggested init size 0x%llX\n",
+            name, stats.grow_count, (unsigned long long)stats.grow_bytes_copied, (unsigned long long)stats.compact_bytes_moved,
+            (unsigned long long)stats.peak_count, (unsigned long long)stats.peak_alloc_size, (unsigned long long)stats.suggested_init_size);
+}
@@ -0,0 +1,66 @@
+#ifndef CONTAINER_STATS_H
+#define CONTAINER_STATS_H
+/// @file container_stats.h
+/// @brief Opt-in counters for how much work containers spend on growing
+///
+/// Build with BOBTAIL_CONTAINER_STATS defined (the CMake option of the same
+/// name) and every @ref list and @ref queue keeps track of how often it
+/// grew, how many bytes that copied, and how big it got. Dump them with
+/// @ref container_stats_print() at the end of a run, then use the suggested
+/// init size at the call site so it never has to grow.
+///
+/// Without the option, the counters aren't in the structs at all, and
+/// @ref list_stats() / @ref queue_stats() just return zeros.
+/// @note Growth through realloc() is counted as copying the whole old buffer,
+/// even if the allocator managed to grow it in place. That's the worst case,
+/// and there's no way to tell from outside the allocator.
+
+#include <stdbool.h>
+
+#include "int.h"
+
+/// Counters for one container
+typedef struct {
+    /// Number of times the buffer was grown
+    u32 grow_count;
+    /// Bytes copied (or possibly copied) while growing
+    u64 grow_bytes_copied;
+    /// Bytes moved to close gaps, e.g. by ordered removes
+    u64 compact_bytes_moved;
+    /// Most elements the container held at once
+    csize peak_count;
+    /// Biggest the buffer got, in bytes
+    u64 peak_alloc_size;
+    /// @brief Init size that would have fit the peak without growing.
+    ///
+    /// Filled in by @ref list_stats() / @ref queue_stats(), since it depends
+    /// on the container.
+    u64 suggested_init_size;
+}container_stats;
+
+/// Whether the library was built with the counters turned on
+bool container_stats_enabled();
+
+/// @brief Log a container's counters on one line.
+/// @param name Something to identify the container by, like the call site
+/// @param stats Counters from @ref list_stats() or @ref queue_stats()
+void container_stats_print(const char* name, container_stats stats);
+
+// Hooks used inside the containers. They compile to nothing when the stats
+// are turned off.
+#ifdef BOBTAIL_CONTAINER_STATS
+    #define CONTAINER_STATS_GROW(stats, copied, new_size) \
+        do { \
+            (stats).grow_count++; \
+            (stats).grow_bytes_copied += (copied); \
+            (stats).peak_alloc_size = MAX((stats).peak_alloc_size, (u64)(new_size)); \
+        } while (0)
+    #define CONTAINER_STATS_COMPACT(stats, moved) ((stats).compact_bytes_moved += (moved))
+    #define CONTAINER_STATS_COUNT(stats, count) ((stats).peak_count = MAX((stats).peak_count, (count)))
+#else
+    #define CONTAINER_STATS_GROW(stats, copied, new_size) ((void)0)
+    #define CONTAINER_STATS_COMPACT(stats, moved) ((void)0)
+    #define CONTAINER_STATS_COUNT(stats, count) ((void)0)
+#endif
+
+#endif // #ifndef CONTAINER_STATS_H
@@ -45,6 +45,10 @@ u32 file_size(const char* path) {
 }
 
 u8* file_load(const char* path) {
+    return file_load_alloc(path, NULL);
+}
+
+u8* file_load_alloc(const char* path, const allocator* a) {
     if (!file_exists(path)) {
         LOG_MSG(error, "File \"%s\" doesn't exist.\n", path);
         return NULL;
@@ -52,7 +56,7 @@ u8* file_load(const char* path) {
     const u32 size = file_size(path);
     // 1 extra byte for a bit of wiggle room
     // (prevents some out of bounds reads while looping over file contents)
-    u8* buffer = calloc(1, size + 1);
+    u8* buffer = allocator_calloc(a, (size_t)size + 1);
     if (buffer == NULL) {
         return NULL;
     }
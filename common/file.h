@@ -6,6 +6,7 @@
 #include <stdbool.h>
 
 #include "int.h"
+#include "allocator.h"
 
 /// Check if a path exists (doesn't necessarily mean it's a file)
 bool file_exists(const char* path);
@@ -27,6 +28,13 @@ u32 file_size(const char* path);
 /// @return Pointer to buffer, or NULL on failure.
 u8* file_load(const char* path);
 
+/// @brief Read an entire file into a buffer from a specific allocator.
+/// @param path Filepath
+/// @param a Allocator for the buffer, or NULL for the default. Free the
+/// buffer with allocator_free() on the same allocator.
+/// @return Pointer to buffer (@ref file_size() + 1 bytes), or NULL on failure.
+u8* file_load_alloc(const char* path, const allocator* a);
+
 /// @brief Read an entire file into an existing buffer.
 /// @param path Filepath
 /// @param buf Buffer to read file into
@@ -0,0 +1,53 @@
+#ifndef FMAP_H
+#define FMAP_H
+/// @file fmap.h
+/// @brief Cross-platform memory-mapped files
+///
+/// Maps a whole file into memory for reading & writing. Changes go straight
+/// into the OS page cache, which writes them back to disk on its own time (or
+/// right away with @ref fmap_sync()).
+/// @sa vmem.h
+
+#include <stdbool.h>
+
+#include "int.h"
+
+/// A file mapped into memory
+typedef struct {
+    /// Start of the mapping, or NULL if nothing is mapped
+    u8* ptr;
+    /// Size of the mapping, which is always the size of the file
+    u64 size;
+    /// OS file handle (fd on POSIX, HANDLE on Windows)
+    uintptr_t file;
+    /// OS file mapping handle (only used on Windows)
+    uintptr_t mapping;
+}fmap;
+
+/// @brief Open (or create) a file and map it into memory.
+/// @param path Filepath
+/// @param min_size If the file is smaller than this, it's extended with zeros.
+/// Must be non-zero if the file might not exist yet, since an empty file
+/// can't be mapped.
+/// @return The new mapping, with a NULL @ref fmap.ptr on failure.
+/// @sa fmap_close
+fmap fmap_open(const char* path, u64 min_size);
+
+/// @brief Change the size of a mapped file.
+///
+/// @warning The mapping can move! Any pointers into it are invalid after this.
+/// @return Whether it succeeded. On failure, the old mapping is left alone if
+/// possible, otherwise @ref fmap.ptr will be NULL.
+bool fmap_resize(fmap* m, u64 size);
+
+/// @brief Block until all changes are written to disk.
+/// @return Whether it succeeded.
+bool fmap_sync(fmap m);
+
+/// @brief Unmap and close the file & fill all fields with 0.
+///
+/// Changes are still written to disk eventually, even without
+/// @ref fmap_sync().
+void fmap_close(fmap* m);
+
+#endif // #ifndef FMAP_H
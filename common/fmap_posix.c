@@ -0,0 +1,83 @@
+// POSIX (Linux, BSD, Apple, generic Unix) implementation of fmap.h interface
+
+#include "platform.h"
+
+#ifdef PLATFORM_POSIX
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "int.h"
+#include "logging.h"
+#include "fmap.h"
+
+// Map the entire file, which must already be the right size
+static bool fmap_map(fmap* m) {
+    void* ptr = mmap(NULL, m->size, PROT_READ | PROT_WRITE, MAP_SHARED, (int)m->file, 0);
+    if (ptr == MAP_FAILED) {
+        m->ptr = NULL;
+        return false;
+    }
+    m->ptr = ptr;
+    return true;
+}
+
+fmap fmap_open(const char* path, u64 min_size) {
+    const int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd == -1) {
+        LOG_MSG(error, "Couldn't open \"%s\"\n", path);
+        return (fmap){0};
+    }
+
+    struct stat st = {0};
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return (fmap){0};
+    }
+    u64 size = st.st_size;
+    if (size < min_size) {
+        if (ftruncate(fd, min_size) != 0) {
+            LOG_MSG(error, "Couldn't extend \"%s\" to 0x%llX bytes\n", path, (unsigned long long)min_size);
+            close(fd);
+            return (fmap){0};
+        }
+        size = min_size;
+    }
+
+    fmap m = { .file = (uintptr_t)fd, .size = size };
+    if (size == 0 || !fmap_map(&m)) {
+        LOG_MSG(error, "Couldn't map \"%s\"\n", path);
+        close(fd);
+        return (fmap){0};
+    }
+    return m;
+}
+
+bool fmap_resize(fmap* m, u64 size) {
+    // Unmapping first keeps this portable, since only Linux has mremap()
+    munmap(m->ptr, m->size);
+    m->ptr = NULL;
+    if (ftruncate((int)m->file, size) != 0) {
+        LOG_MSG(error, "Couldn't resize file 0x%llX -> 0x%llX\n", (unsigned long long)m->size, (unsigned long long)size);
+        // Try to get the old mapping back
+        fmap_map(m);
+        return false;
+    }
+    m->size = size;
+    return fmap_map(m);
+}
+
+bool fmap_sync(fmap m) {
+    return msync(m.ptr, m.size, MS_SYNC) == 0;
+}
+
+void fmap_close(fmap* m) {
+    if (m->ptr != NULL) {
+        munmap(m->ptr, m->size);
+    }
+    close((int)m->file);
+    *m = (fmap){0};
+}
+#endif
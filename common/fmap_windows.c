@@ -0,0 +1,98 @@
+// Windows implementation of fmap.h interface
+
+#include "platform.h"
+
+#ifdef PLATFORM_WINDOWS
+#include <Windows.h>
+#include <stdlib.h>
+
+#include "int.h"
+#include "logging.h"
+#include "fmap.h"
+
+// Create a mapping object & view of the entire file, which must already be the
+// right size.
+static bool fmap_map(fmap* m) {
+    HANDLE mapping = CreateFileMappingA((HANDLE)m->file, NULL, PAGE_READWRITE, (DWORD)(m->size >> 32), (DWORD)(m->size & UINT32_MAX), NULL);
+    if (mapping == NULL) {
+        m->ptr = NULL;
+        return false;
+    }
+    void* ptr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, m->size);
+    if (ptr == NULL) {
+        CloseHandle(mapping);
+        m->ptr = NULL;
+        return false;
+    }
+    m->mapping = (uintptr_t)mapping;
+    m->ptr = ptr;
+    return true;
+}
+
+static void fmap_unmap(fmap* m) {
+    if (m->ptr != NULL) {
+        UnmapViewOfFile(m->ptr);
+        CloseHandle((HANDLE)m->mapping);
+    }
+    m->ptr = NULL;
+    m->mapping = 0;
+}
+
+static bool fmap_set_file_size(fmap* m, u64 size) {
+    LARGE_INTEGER pos = { .QuadPart = size };
+    return SetFilePointerEx((HANDLE)m->file, pos, NULL, FILE_BEGIN) && SetEndOfFile((HANDLE)m->file);
+}
+
+fmap fmap_open(const char* path, u64 min_size) {
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_MSG(error, "Couldn't open \"%s\"\n", path);
+        return (fmap){0};
+    }
+
+    LARGE_INTEGER file_size = {0};
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return (fmap){0};
+    }
+    fmap m = { .file = (uintptr_t)file, .size = file_size.QuadPart };
+    if (m.size < min_size) {
+        if (!fmap_set_file_size(&m, min_size)) {
+            LOG_MSG(error, "Couldn't extend \"%s\" to 0x%llX bytes\n", path, (unsigned long long)min_size);
+            CloseHandle(file);
+            return (fmap){0};
+        }
+        m.size = min_size;
+    }
+
+    if (m.size == 0 || !fmap_map(&m)) {
+        LOG_MSG(error, "Couldn't map \"%s\"\n", path);
+        CloseHandle(file);
+        return (fmap){0};
+    }
+    return m;
+}
+
+bool fmap_resize(fmap* m, u64 size) {
+    // The file can't be resized while it's mapped
+    fmap_unmap(m);
+    if (!fmap_set_file_size(m, size)) {
+        LOG_MSG(error, "Couldn't resize file 0x%llX -> 0x%llX\n", (unsigned long long)m->size, (unsigned long long)size);
+        // Try to get the old mapping back
+        fmap_map(m);
+        return false;
+    }
+    m->size = size;
+    return fmap_map(m);
+}
+
+bool fmap_sync(fmap m) {
+    return FlushViewOfFile(m.ptr, 0) && FlushFileBuffers((HANDLE)m.file);
+}
+
+void fmap_close(fmap* m) {
+    fmap_unmap(m);
+    CloseHandle((HANDLE)m->file);
+    *m = (fmap){0};
+}
+#endif
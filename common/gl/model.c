@@ -40,6 +40,10 @@ u32 model_size(const model m) {
 }
 
 model obj_load(u8* txt) {
+    return obj_load_alloc(txt, NULL);
+}
+
+model obj_load_alloc(u8* txt, const allocator* a) {
     vertex* vertices = NULL;
     u16* indices = NULL;
     u16 vert_count = 0;
@@ -108,8 +112,8 @@ model obj_load(u8* txt) {
 
         // Before the second pass, we need to alloc the vertex & index buffers.
         if (tally_pass) {
-            vertices = calloc(vert_count, sizeof(vertex));
-            indices = calloc(idx_count, sizeof(u16));
+            vertices = allocator_calloc(a, vert_count * sizeof(vertex));
+            indices = allocator_calloc(a, idx_count * sizeof(u16));
             if (vertices == NULL || indices == NULL) {
                 LOG_MSG(error, "Buffer alloc failure!\n");
                 printf("\tVertex buffer %p (0x%hx bytes)\n", vertices, vert_count * (u16)sizeof(vertex));
@@ -4,6 +4,7 @@
 /// @brief Model loading utilities
 
 #include "vector.h"
+#include <common/allocator.h>
 
 /// A vertex with only posiiton and color
 typedef struct {
@@ -49,4 +50,10 @@ u32 model_size(const model m);
 /// @note This allocates memory!
 model obj_load(u8* txt);
 
+/// @brief Same as @ref obj_load(), but the vertex & index buffers come from a
+/// specific allocator.
+/// @param a Allocator for the buffers, or NULL for the default. Free them
+/// with allocator_free() on the same allocator.
+model obj_load_alloc(u8* txt, const allocator* a);
+
 #endif // MODEL_H
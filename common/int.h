@@ -25,6 +25,19 @@ typedef int32_t s32;
 /// Shorthand for signed 64-bit integer
 typedef int64_t s64;
 
+/// @brief Size & index type used by the dynamic containers (list, queue, etc.)
+///
+/// This is 32 bits by default, which caps every container at 4GiB of backing
+/// buffer. Define BOBTAIL_CONTAINER_64 (or turn on the CMake option with the
+/// same name) to make it 64 bits, at the cost of slightly bigger structs.
+#ifdef BOBTAIL_CONTAINER_64
+typedef u64 csize;
+#define CSIZE_MAX UINT64_MAX
+#else
+typedef u32 csize;
+#define CSIZE_MAX UINT32_MAX
+#endif
+
 /// @brief Dedicated integer type for GL object IDs.
 ///
 /// This is the same type as GLuint, to avoid lots of linter warnings
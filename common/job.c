@@ -0,0 +1,443 @@
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "logging.h"
+#include "allocator.h"
+#include "thread.h"
+#include "queue_mpmc.h"
+#include "job.h"
+
+enum {
+    /// Jobs each worker's deque can hold. Submitting past this runs the job inline.
+    JOB_DEQUE_CAPACITY = 1 << 12,
+    /// Jobs the queue for submissions from outside the pool can hold
+    JOB_INJECT_CAPACITY = 1 << 12,
+    /// How many times to look for work before going to sleep
+    JOB_SPIN_ROUNDS = 64,
+    /// Pieces per thread when @ref job_parallel_for() picks the grain size
+    JOB_PIECES_PER_THREAD = 8,
+};
+
+/// Set in @ref job_group.pending when a thread is asleep waiting on it
+#define JOB_GROUP_SLEEPING (1u << 31)
+/// The rest of @ref job_group.pending is the count
+#define JOB_GROUP_COUNT_MASK (JOB_GROUP_SLEEPING - 1)
+
+enum {
+    JOB_SYSTEM_STOPPED,
+    JOB_SYSTEM_STARTING,
+    JOB_SYSTEM_RUNNING,
+};
+
+typedef struct {
+    job_proc proc;
+    void* arg;
+    job_group* group;
+}job;
+
+/// @brief A job in a deque.
+///
+/// A thief can read a slot while the owner is overwriting it (it'll fail
+/// its CAS & throw the result away), so every field is atomic to keep that
+/// read well-defined.
+typedef struct {
+    _Atomic(uintptr_t) proc;
+    _Atomic(uintptr_t) arg;
+    _Atomic(uintptr_t) group;
+}job_slot;
+
+/// @brief Chase-Lev work-stealing deque with a fixed capacity.
+///
+/// The owner pushes & pops at the bottom without any CAS, except when taking
+/// the very last job. Thieves take from the top with a CAS. The two ends are
+/// on separate cache lines.
+typedef struct {
+    _Atomic(s64) top;
+    u8 pad0[CACHE_LINE_SIZE];
+    _Atomic(s64) bottom;
+    u8 pad1[CACHE_LINE_SIZE];
+    job_slot slots[JOB_DEQUE_CAPACITY];
+}job_deque;
+
+typedef struct {
+    /// One deque per worker
+    job_deque* deques;
+    /// Workers that actually started
+    thread* threads;
+    u32 thread_count;
+    u32 worker_count;
+    /// Jobs submitted from threads outside the pool
+    queue_mpmc injected;
+    const allocator* alloc;
+    u8 pad0[CACHE_LINE_SIZE];
+
+    /// Bumped to wake sleeping workers
+    _Atomic(u32) work_seq;
+    /// Number of workers asleep (or about to be)
+    _Atomic(u32) sleepers;
+    _Atomic(bool) stopping;
+}job_system;
+
+static job_system jobs;
+static _Atomic(u32) jobs_state = JOB_SYSTEM_STOPPED;
+
+/// Index + 1 of the worker running on this thread, or 0 if it's not a worker
+static _Thread_local u32 job_worker_slot;
+/// Random state for picking steal victims
+static _Thread_local u64 job_rng;
+
+static u32 job_rand() {
+    if (job_rng == 0) {
+        // Any per-thread value works as a seed
+        job_rng = ((u64)(uintptr_t)&job_rng * 0x9E3779B97F4A7C15) | 1;
+    }
+    job_rng ^= job_rng << 13;
+    job_rng ^= job_rng >> 7;
+    job_rng ^= job_rng << 17;
+    return (u32)(job_rng >> 32);
+}
+
+static void job_slot_store(job_slot* slot, job j) {
+    atomic_store_explicit(&slot->proc, (uintptr_t)j.proc, memory_order_relaxed);
+    atomic_store_explicit(&slot->arg, (uintptr_t)j.arg, memory_order_relaxed);
+    atomic_store_explicit(&slot->group, (uintptr_t)j.group, memory_order_relaxed);
+}
+
+static job job_slot_load(job_slot* slot) {
+    return (job) {
+        .proc = (job_proc)atomic_load_explicit(&slot->proc, memory_order_relaxed),
+        .arg = (void*)atomic_load_explicit(&slot->arg, memory_order_relaxed),
+        .group = (job_group*)atomic_load_explicit(&slot->group, memory_order_relaxed),
+    };
+}
+
+/// Add a job to the bottom. Only the owner can call this.
+static bool job_deque_push(job_deque* d, job j) {
+    const s64 b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    const s64 t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t >= JOB_DEQUE_CAPACITY) {
+        return false;
+    }
+    job_slot_store(&d->slots[b & (JOB_DEQUE_CAPACITY - 1)], j);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+/// Take the newest job from the bottom. Only the owner can call this.
+static bool job_deque_pop(job_deque* d, job* out) {
+    const s64 b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    // Claim the slot first, then check for thieves. Both have to be seq_cst
+    // so a thief can't read the old bottom after we've read the old top.
+    atomic_store(&d->bottom, b);
+    s64 t = atomic_load(&d->top);
+    if (t > b) {
+        // Empty
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_release);
+        return false;
+    }
+
+    *out = job_slot_load(&d->slots[b & (JOB_DEQUE_CAPACITY - 1)]);
+    if (t < b) {
+        // More than 1 job left, thieves can't reach this one
+        return true;
+    }
+    // This is the last job, so we have to race the thieves for it
+    const bool won = atomic_compare_exchange_strong(&d->top, &t, t + 1);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_release);
+    return won;
+}
+
+/// Take the oldest job from the top. Any thread can call this.
+static bool job_deque_steal(job_deque* d, job* out) {
+    s64 t = atomic_load(&d->top);
+    const s64 b = atomic_load(&d->bottom);
+    if (t >= b) {
+        return false;
+    }
+    *out = job_slot_load(&d->slots[t & (JOB_DEQUE_CAPACITY - 1)]);
+    // If this fails, the owner or another thief got it first & what we
+    // read might be garbage
+    return atomic_compare_exchange_strong(&d->top, &t, t + 1);
+}
+
+static void job_run(job j) {
+    job_group* group = j.group;
+    j.proc(j.arg);
+    // Once the count hits 0 the group can go out of scope, so it can't be
+    // touched after this, unless a waiter is asleep. That waiter doesn't
+    // return until woken is set, so setting it has to be the last touch.
+    const u32 old = atomic_fetch_sub(&group->pending, 1);
+    if (old == (JOB_GROUP_SLEEPING | 1)) {
+        thread_wake_all(&group->pending);
+        atomic_store(&group->woken, 1);
+    }
+}
+
+/// Look everywhere for a job: our own deque, the shared queue, then other
+/// workers' deques.
+static bool job_find(job* out) {
+    const u32 self = job_worker_slot;
+    if (self != 0 && job_deque_pop(&jobs.deques[self - 1], out)) {
+        return true;
+    }
+    if (queue_mpmc_try_pop(&jobs.injected, out)) {
+        return true;
+    }
+    const u32 count = jobs.worker_count;
+    if (count == 0) {
+        return false;
+    }
+    // Start at a random victim, so thieves don't all pile onto the same one
+    const u32 start = job_rand() % count;
+    for (u32 i = 0; i < count; i++) {
+        const u32 victim = (start + i) % count;
+        if (victim + 1 != self && job_deque_steal(&jobs.deques[victim], out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void job_worker(void* arg) {
+    job_worker_slot = (u32)(uintptr_t)arg + 1;
+    job j = {0};
+    while (true) {
+        bool found = false;
+        for (u32 i = 0; i < JOB_SPIN_ROUNDS && !found; i++) {
+            found = job_find(&j);
+            if (!found) {
+                thread_pause();
+            }
+        }
+        if (found) {
+            job_run(j);
+            continue;
+        }
+
+        // Register as a sleeper before the last look, so a submit that we
+        // miss sees us & wakes us up. Pairs with the fence in job_submit().
+        atomic_fetch_add(&jobs.sleepers, 1);
+        const u32 seq = atomic_load(&jobs.work_seq);
+        if (atomic_load(&jobs.stopping)) {
+            atomic_fetch_sub(&jobs.sleepers, 1);
+            break;
+        }
+        found = job_find(&j);
+        if (!found) {
+            thread_wait(&jobs.work_seq, seq, THREAD_WAIT_FOREVER);
+        }
+        atomic_fetch_sub(&jobs.sleepers, 1);
+        if (found) {
+            job_run(j);
+        }
+    }
+}
+
+bool job_system_init(u32 worker_count) {
+    u32 expected = JOB_SYSTEM_STOPPED;
+    if (!atomic_compare_exchange_strong(&jobs_state, &expected, JOB_SYSTEM_STARTING)) {
+        // Someone else is starting it, wait until they're done
+        u32 spins = 0;
+        while (atomic_load(&jobs_state) == JOB_SYSTEM_STARTING) {
+            thread_backoff(&spins);
+        }
+        return false;
+    }
+
+    if (worker_count == 0) {
+        worker_count = thread_cpu_count() - 1;
+    }
+    const allocator* a = allocator_default();
+    jobs = (job_system) {
+        .worker_count = worker_count,
+        .injected = queue_mpmc_create(JOB_INJECT_CAPACITY, sizeof(job)),
+        .alloc = a,
+    };
+    atomic_init(&jobs.work_seq, 0);
+    atomic_init(&jobs.sleepers, 0);
+    atomic_init(&jobs.stopping, false);
+    if (worker_count > 0) {
+        jobs.deques = allocator_alloc(a, (size_t)worker_count * sizeof(*jobs.deques));
+        jobs.threads = allocator_alloc(a, (size_t)worker_count * sizeof(*jobs.threads));
+    }
+    if (jobs.injected.cells == NULL || (worker_count > 0 && (jobs.deques == NULL || jobs.threads == NULL))) {
+        LOG_MSG(error, "Failed to allocate job system for %u workers\n", worker_count);
+        allocator_free(a, jobs.deques);
+        allocator_free(a, jobs.threads);
+        queue_mpmc_destroy(&jobs.injected);
+        jobs = (job_system){0};
+        atomic_store(&jobs_state, JOB_SYSTEM_STOPPED);
+        return false;
+    }
+
+    for (u32 i = 0; i < worker_count; i++) {
+        atomic_init(&jobs.deques[i].top, 0);
+        atomic_init(&jobs.deques[i].bottom, 0);
+    }
+    for (u32 i = 0; i < worker_count; i++) {
+        // A worker that didn't start just leaves its deque empty
+        if (thread_create(&jobs.threads[jobs.thread_count], job_worker, (void*)(uintptr_t)i)) {
+            jobs.thread_count++;
+        }
+    }
+    atomic_store(&jobs_state, JOB_SYSTEM_RUNNING);
+    return true;
+}
+
+void job_system_shutdown() {
+    // Shutting down looks like starting up to anyone calling init
+    u32 expected = JOB_SYSTEM_RUNNING;
+    if (!atomic_compare_exchange_strong(&jobs_state, &expected, JOB_SYSTEM_STARTING)) {
+        return;
+    }
+    atomic_store(&jobs.stopping, true);
+    atomic_fetch_add(&jobs.work_seq, 1);
+    thread_wake_all(&jobs.work_seq);
+    for (u32 i = 0; i < jobs.thread_count; i++) {
+        thread_join(jobs.threads[i]);
+    }
+
+    allocator_free(jobs.alloc, jobs.deques);
+    allocator_free(jobs.alloc, jobs.threads);
+    queue_mpmc_destroy(&jobs.injected);
+    jobs = (job_system){0};
+    atomic_store(&jobs_state, JOB_SYSTEM_STOPPED);
+}
+
+/// Start the pool if it isn't running yet. Returns false if it couldn't start.
+static bool job_system_ensure_started() {
+    if (atomic_load_explicit(&jobs_state, memory_order_acquire) == JOB_SYSTEM_RUNNING) {
+        return true;
+    }
+    job_system_init(0);
+    return atomic_load(&jobs_state) == JOB_SYSTEM_RUNNING;
+}
+
+u32 job_worker_count() {
+    if (atomic_load(&jobs_state) != JOB_SYSTEM_RUNNING) {
+        return 0;
+    }
+    return jobs.worker_count;
+}
+
+void job_submit(job_group* group, job_proc proc, void* arg) {
+    atomic_fetch_add(&group->pending, 1);
+    const job j = { .proc = proc, .arg = arg, .group = group };
+    if (!job_system_ensure_started()) {
+        job_run(j);
+        return;
+    }
+
+    const u32 self = job_worker_slot;
+    const bool queued = (self != 0) ? job_deque_push(&jobs.deques[self - 1], j) : queue_mpmc_try_push(&jobs.injected, &j);
+    if (!queued) {
+        // Everything's backed up anyway, so this thread may as well help
+        job_run(j);
+        return;
+    }
+
+    // Publish the job before checking for sleepers. Either a worker about to
+    // sleep sees the job, or we see the worker & wake it.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(&jobs.sleepers) > 0) {
+        atomic_fetch_add(&jobs.work_seq, 1);
+        thread_wake_one(&jobs.work_seq);
+    }
+}
+
+void job_wait(job_group* group) {
+    u32 spins = 0;
+    job j = {0};
+    while (true) {
+        u32 pending = atomic_load(&group->pending);
+        if ((pending & JOB_GROUP_COUNT_MASK) == 0) {
+            break;
+        }
+        if (job_find(&j)) {
+            job_run(j);
+            spins = 0;
+            continue;
+        }
+        if (spins < JOB_SPIN_ROUNDS || jobs.worker_count == 0) {
+            // With no workers, a job could show up in the shared queue
+            // without anyone waking us, so keep looking instead of sleeping
+            thread_backoff(&spins);
+            continue;
+        }
+
+        // The rest of the group is running on other threads. Mark that we're
+        // asleep, so whoever finishes the last job wakes us up.
+        if ((pending & JOB_GROUP_SLEEPING) == 0) {
+            atomic_compare_exchange_strong(&group->pending, &pending, pending | JOB_GROUP_SLEEPING);
+            continue;
+        }
+        thread_wait(&group->pending, pending, THREAD_WAIT_FOREVER);
+    }
+    if ((atomic_load(&group->pending) & JOB_GROUP_SLEEPING) != 0) {
+        // The last job saw the sleeping flag, so it's waking us. Wait for it
+        // to finish, since the group can go away as soon as we return.
+        spins = 0;
+        while (atomic_load(&group->woken) == 0) {
+            thread_backoff(&spins);
+        }
+    }
+    // Clear the flags, so the group can be reused
+    atomic_store(&group->woken, 0);
+    atomic_store(&group->pending, 0);
+}
+
+/// Shared state for one @ref job_parallel_for() call
+typedef struct {
+    job_range_proc proc;
+    void* arg;
+    csize count;
+    csize grain;
+    /// Start of the next piece to hand out. 64-bit, so it can't wrap when
+    /// every thread overshoots the end.
+    _Atomic(u64) next;
+}job_range;
+
+static void job_range_run(void* arg) {
+    job_range* range = arg;
+    while (true) {
+        const u64 begin = atomic_fetch_add_explicit(&range->next, range->grain, memory_order_relaxed);
+        if (begin >= range->count) {
+            break;
+        }
+        range->proc(range->arg, (csize)begin, (csize)MIN(begin + range->grain, range->count));
+    }
+}
+
+void job_parallel_for(csize count, csize grain, job_range_proc proc, void* arg) {
+    if (count == 0) {
+        return;
+    }
+    if (!job_system_ensure_started()) {
+        proc(arg, 0, count);
+        return;
+    }
+
+    const u32 threads = jobs.worker_count + 1;
+    if (grain == 0) {
+        grain = MAX(count / (threads * JOB_PIECES_PER_THREAD), 1);
+    }
+    job_range range = {
+        .proc = proc,
+        .arg = arg,
+        .count = count,
+        .grain = grain,
+    };
+    atomic_init(&range.next, 0);
+
+    // Pieces are claimed from a shared counter, so we only need 1 job per
+    // thread instead of 1 per piece
+    const u64 pieces = ((u64)count + grain - 1) / grain;
+    const u32 helpers = (u32)MIN(pieces, threads) - 1;
+    job_group group = {0};
+    for (u32 i = 0; i < helpers; i++) {
+        job_submit(&group, job_range_run, &range);
+    }
+    job_range_run(&range);
+    job_wait(&group);
+}
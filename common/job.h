@@ -0,0 +1,95 @@
+#ifndef JOB_H
+#define JOB_H
+/// @file job.h
+/// @brief Work-stealing job system
+///
+/// A pool of worker threads that run small jobs, shared by everything in the
+/// process. Each worker has its own Chase-Lev deque: it pushes & pops jobs at
+/// the bottom (newest first, which keeps its data in cache), and idle workers
+/// steal from the top of other workers' deques (oldest first, which tends to
+/// be the biggest piece of work). Jobs submitted from threads outside the
+/// pool go through a shared @ref queue_mpmc instead. Workers with nothing to
+/// do sleep on a futex, so an idle pool costs no CPU.
+///
+/// Jobs are tracked with a @ref job_group. Waiting on a group doesn't just
+/// block: the waiting thread runs jobs until the group is done, so jobs can
+/// submit & wait for their own sub-jobs (fork-join) without deadlocking.
+///
+/// The pool starts itself on first use with one worker per CPU, minus one for
+/// the thread that waits. Call @ref job_system_init() first to pick a
+/// different worker count.
+/// @sa thread.h
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "thread.h"
+
+/// A job to run on the pool
+typedef void (*job_proc)(void* arg);
+
+/// @brief Function run by @ref job_parallel_for() on a range of indices.
+/// @param arg The argument passed to @ref job_parallel_for()
+/// @param begin First index in the range
+/// @param end One past the last index in the range
+typedef void (*job_range_proc)(void* arg, csize begin, csize end);
+
+/// @brief A set of jobs that can be waited on together.
+///
+/// Zero-initialize it before use, it needs no cleanup. The same group can be
+/// reused after @ref job_wait() returns.
+typedef struct {
+    /// Number of submitted jobs that haven't finished yet
+    _Atomic(u32) pending;
+    /// Set by whoever finishes the last job once it's done waking a sleeping
+    /// waiter, so the group stays alive until then
+    _Atomic(u32) woken;
+}job_group;
+
+/// @brief Start the worker threads.
+///
+/// This only needs to be called to pick the number of workers, the pool
+/// starts itself on first use otherwise.
+/// @param worker_count Number of worker threads. 0 means one per CPU, minus
+/// one for the calling thread.
+/// @return False if the pool is already running or we ran out of memory
+/// @sa job_system_shutdown
+bool job_system_init(u32 worker_count);
+
+/// @brief Stop & join all the worker threads.
+/// @warning Every submitted job must be finished (waited on) first, and no
+/// other threads can be submitting jobs.
+void job_system_shutdown();
+
+/// Number of worker threads in the pool (0 if it isn't running)
+u32 job_worker_count();
+
+/// @brief Run a job on the pool.
+///
+/// If the pool's queues are full, the job runs right away on this thread.
+/// @param group Group to add the job to, which has to be waited on before
+/// it goes out of scope
+/// @param proc Function to run
+/// @param arg Argument passed to @p proc
+void job_submit(job_group* group, job_proc proc, void* arg);
+
+/// @brief Wait until every job in a group has finished.
+///
+/// While waiting, this thread runs other jobs from the pool (including ones
+/// from other groups). It only goes to sleep once there's nothing to run.
+void job_wait(job_group* group);
+
+/// @brief Call @p proc on every index in [0, @p count), split into pieces
+/// that run in parallel. Returns once they're all done.
+///
+/// Pieces are handed out to threads dynamically, so uneven work still gets
+/// balanced.
+/// @param count Number of indices
+/// @param grain Number of indices in each piece. Make this big enough that
+/// each piece takes at least a few microseconds. 0 picks one for you.
+/// @param proc Function to run on each piece
+/// @param arg Argument passed to @p proc
+void job_parallel_for(csize count, csize grain, job_range_proc proc, void* arg);
+
+#endif // #ifndef JOB_H
@@ -2,65 +2,362 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <sys/stat.h>
 
 #include "int.h"
 #include "logging.h"
+#include "vmem.h"
+#include "fmap.h"
+#include "file.h"
 #include "list.h"
 
-u32 list_maxidx(list l) {
+// SSE2 is baseline on x86-64, AVX2 is only used if the compiler is allowed to
+// emit it (e.g. -mavx2 or -march=native).
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define LIST_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define LIST_SIMD_SSE2 1
+#endif
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+csize list_maxidx(list l) {
     return (l.alloc_size / l.element_size) - 1;
 }
 
 bool list_full(list l) {
-    return l.end_idx >= list_maxidx(l);
+    // An empty buffer (like in a zero-initialized list) would make the max
+    // index wrap around
+    return l.alloc_size < l.element_size || l.end_idx >= list_maxidx(l);
 }
 
-void* list_get_element(list l, u32 idx) {
+void* list_get_element(list l, csize idx) {
     return (void*)(l.data + (idx * l.element_size));
 }
 
-list list_create(u32 init_size, u32 element_size) {
+list list_create(csize init_size, csize element_size) {
+    return list_create_alloc(init_size, element_size, NULL);
+}
+
+list list_create_alloc(csize init_size, csize element_size, const allocator* a) {
+    // Look up the default now, so the list is always freed by whatever
+    // allocated it (even if the default changes).
+    a = (a != NULL) ? a : allocator_default();
     return (list) {
         .element_size = element_size,
-        .data = (uintptr_t)calloc(1, init_size),
+        .data = (uintptr_t)allocator_calloc(a, init_size),
         .alloc_size = init_size,
+        .alloc = a,
+    };
+}
+
+list list_create_reserved(u64 max_bytes, csize element_size) {
+    // alloc_size can't go past CSIZE_MAX, so anything after that can never be
+    // used. Round down so we only ever commit whole pages.
+    const u64 usable = MIN(max_bytes, CSIZE_MAX);
+    const u64 reserve_size = usable - (usable % VMEM_PAGE_SIZE);
+    if (reserve_size < element_size || element_size == 0) {
+        LOG_MSG(error, "Can't fit any 0x%llX byte elements in a 0x%llX byte reservation\n", (unsigned long long)element_size, (unsigned long long)max_bytes);
+        return (list){0};
+    }
+
+    void* base = vmem_reserve(reserve_size);
+    if (base == NULL) {
+        LOG_MSG(error, "Couldn't reserve 0x%llX bytes of address space\n", (unsigned long long)reserve_size);
+        return (list){0};
+    }
+
+    // Commit enough to hold at least one element right away
+    const csize init_size = MIN(ALIGN_UP((u64)element_size, VMEM_PAGE_SIZE), reserve_size);
+    if (vmem_commit(base, init_size) != 0) {
+        LOG_MSG(error, "Couldn't commit initial 0x%llX bytes\n", (unsigned long long)init_size);
+        vmem_free(base, reserve_size);
+        return (list){0};
+    }
+
+    return (list) {
+        .element_size = element_size,
+        .data = (uintptr_t)base,
+        .alloc_size = init_size,
+        .reserve_size = reserve_size,
+    };
+}
+
+/// @brief Header at the start of files used by list_map_file()
+///
+/// This is padded to 64 bytes, so the elements after it stay aligned.
+typedef struct {
+    /// Always @ref LIST_FILE_MAGIC
+    u32 magic;
+    /// Always @ref LIST_FILE_VERSION
+    u32 version;
+    /// Element size the list was created with
+    u64 element_size;
+    /// Number of elements, as of the last list_sync() or list_destroy()
+    u64 count;
+    u8 padding[40];
+}list_file_header;
+
+enum {
+    LIST_FILE_MAGIC = MAGIC('B', 'L', 'S', 'T'),
+    LIST_FILE_VERSION = 1,
+};
+
+/// @brief Whether a list file needs to be created (it's missing or empty).
+///
+/// file_size() returns a u32, which truncates: an existing list file whose
+/// size is a multiple of 4GiB would look empty & get overwritten. So this
+/// reads the full 64-bit size instead.
+static bool list_file_is_new(const char* path) {
+#if defined(_MSC_VER)
+    struct _stat64 st = {0};
+    if (_stat64(path, &st) != 0) {
+        return true;
+    }
+#else
+    struct stat st = {0};
+    if (stat(path, &st) != 0) {
+        return true;
+    }
+#endif
+    return st.st_size == 0;
+}
+
+list list_map_file(const char* path, csize element_size) {
+    if (element_size == 0) {
+        return (list){0};
+    }
+    const allocator* a = allocator_default();
+    fmap* file = allocator_alloc(a, sizeof(*file));
+    if (file == NULL) {
+        return (list){0};
+    }
+
+    // New files start with room for a few elements. Existing files are opened
+    // as-is, so a file that turns out not to be a list is never modified.
+    const u64 min_size = sizeof(list_file_header) + (16 * (u64)element_size);
+    const bool is_new = list_file_is_new(path);
+    *file = fmap_open(path, is_new ? min_size : 0);
+    if (file->ptr == NULL) {
+        allocator_free(a, file);
+        return (list){0};
+    }
+
+    list_file_header* header = (list_file_header*)file->ptr;
+    if (is_new) {
+        *header = (list_file_header) {
+            .magic = LIST_FILE_MAGIC,
+            .version = LIST_FILE_VERSION,
+            .element_size = element_size,
+        };
+    }
+
+    bool valid = file->size >= sizeof(list_file_header);
+    if (valid) {
+        const u64 capacity = file->size - sizeof(list_file_header);
+        valid = header->magic == LIST_FILE_MAGIC && header->version == LIST_FILE_VERSION;
+        valid = valid && header->element_size == element_size && capacity <= CSIZE_MAX && header->count <= capacity / element_size;
+    }
+    if (!valid) {
+        LOG_MSG(error, "\"%s\" isn't a list file with 0x%llX byte elements (or it's too big)\n", path, (unsigned long long)element_size);
+        fmap_close(file);
+        allocator_free(a, file);
+        return (list){0};
+    }
+    // Only grow the file once we know it's ours
+    if (file->size < min_size && !fmap_resize(file, min_size)) {
+        fmap_close(file);
+        allocator_free(a, file);
+        return (list){0};
+    }
+    header = (list_file_header*)file->ptr;
+    const u64 capacity = file->size - sizeof(list_file_header);
+
+    return (list) {
+        .data = (uintptr_t)(file->ptr + sizeof(list_file_header)),
+        .alloc_size = capacity,
+        .end_idx = header->count,
+        .element_size = element_size,
+        .file = file,
+        .alloc = a,
     };
 }
 
+/// Write the element count into the file header of a file-backed list
+static void list_update_header(list* l) {
+    list_file_header* header = (list_file_header*)l->file->ptr;
+    header->count = l->end_idx;
+}
+
+/// @brief Resize the file of a file-backed list, and update the list to match.
+///
+/// The mapping can move, so the data pointer is always re-read from the file.
+static bool list_resize_file(list* l, u64 newsize) {
+    list_update_header(l);
+    const bool resized = fmap_resize(l->file, sizeof(list_file_header) + newsize);
+    if (l->file->ptr == NULL) {
+        LOG_MSG(error, "Lost the mapping for the list file!\n");
+        l->data = 0;
+        l->alloc_size = 0;
+        l->end_idx = 0;
+        return false;
+    }
+    l->data = (uintptr_t)(l->file->ptr + sizeof(list_file_header));
+    l->alloc_size = l->file->size - sizeof(list_file_header);
+    return resized;
+}
+
+bool list_sync(list* l) {
+    if (l->file == NULL) {
+        return false;
+    }
+    list_update_header(l);
+    return fmap_sync(*l->file);
+}
+
 void list_destroy(list* l) {
     void* data = (void*)l->data;
+    const u64 reserve_size = l->reserve_size;
+    fmap* file = l->file;
+    const allocator* a = l->alloc;
+    if (file != NULL) {
+        list_update_header(l);
+    }
     *l = (list){0};
 
     // This order of operations makes sure there's never a dangling pointer.
-    free((void*)data);
+    if (file != NULL) {
+        fmap_close(file);
+        allocator_free(a, file);
+    }
+    else if (reserve_size != 0) {
+        vmem_free(data, reserve_size);
+    }
+    else {
+        allocator_free(a, data);
+    }
 }
 
-void list_add(list* l, const void* data) {
-    // If there's no room, we need to realloc
-    if (list_full(*l)) {
-        // The buffer is completely full & needs a new allocation.
-        // Grow by 50%, rounded up to the next multiple of our element size.
-        const u32 newsize = ALIGN_UP((u32)(l->alloc_size * 1.5), l->element_size);
-        assert(newsize > l->alloc_size); // Sanity check to avoid memory corruption
-        void* newbuf = calloc(1, newsize);
-        if (newbuf == NULL) {
-            LOG_MSG(error, "Couldn't expand list 0x%X -> 0x%X [alloc failure]\n", l->alloc_size, newsize);
-            return;
+/// @brief Grow the list buffer so it's at least @p min_size bytes.
+///
+/// Normal lists grow by their growth factor (rounded up to the element size) by
+/// allocating a new buffer and copying everything over. Lists made with
+/// list_create_reserved() commit more pages at the end instead, so nothing is
+/// copied and the buffer never moves.
+static bool list_grow(list* l, u64 min_size) {
+    // Growing by a constant factor keeps repeated adds amortized O(1). This is
+    // done in floating point & clamped, so sizes can't silently wrap around.
+    const float factor = (l->growth_factor > 1.0f) ? l->growth_factor : LIST_DEFAULT_GROWTH;
+    const double scaled = (double)l->alloc_size * factor;
+    const u64 grown = (scaled >= (double)UINT64_MAX) ? UINT64_MAX : (u64)scaled;
+
+    if (l->reserve_size != 0) {
+        const u64 wanted = MAX(min_size, grown);
+        // Committing is cheap (physical pages are only used once we touch
+        // them), so we still grow by the growth factor to keep the number of
+        // syscalls down.
+        // The reservation is page-aligned, so clamping to it keeps us aligned.
+        const u64 newsize = (wanted >= l->reserve_size) ? l->reserve_size : MIN(ALIGN_UP(wanted, VMEM_PAGE_SIZE), l->reserve_size);
+        if (newsize < min_size || newsize <= l->alloc_size) {
+            LOG_MSG(error, "List is out of reserved space [0x%llX bytes]\n", (unsigned long long)l->reserve_size);
+            return false;
         }
 
-        // Copy data & update state
-        memcpy(newbuf, (void*)l->data, l->alloc_size);
-        free((void*)l->data);
-        l->data = (uintptr_t)newbuf;
+        void* commit_start = (void*)(l->data + l->alloc_size);
+        if (vmem_commit(commit_start, newsize - l->alloc_size) != 0) {
+            LOG_MSG(error, "Couldn't commit list pages 0x%llX -> 0x%llX\n", (unsigned long long)l->alloc_size, (unsigned long long)newsize);
+            return false;
+        }
+        CONTAINER_STATS_GROW(l->stats, 0, newsize);
         l->alloc_size = newsize;
+        return true;
+    }
+
+    // Only fail if the size we actually need can't fit. The growth factor's
+    // target is just clamped, so lists can still grow right up to the limit.
+    // The limit leaves room for rounding up to the next element below.
+    const u64 limit = (u64)CSIZE_MAX - l->element_size;
+    if (min_size > limit) {
+        LOG_MSG(error, "Couldn't expand list 0x%llX -> 0x%llX [too big]\n", (unsigned long long)l->alloc_size, (unsigned long long)min_size);
+        return false;
+    }
+    const u64 capped = MIN(grown, limit - (limit % l->element_size));
+    const u64 newsize = ALIGN_UP(MAX(min_size, capped), l->element_size);
+    if (l->file != NULL) {
+        // File-backed lists just extend the file
+        if (!list_resize_file(l, newsize)) {
+            return false;
+        }
+        CONTAINER_STATS_GROW(l->stats, 0, newsize);
+        return true;
+    }
+    assert(newsize > l->alloc_size); // Sanity check to avoid memory corruption
+    if (l->alloc == NULL) {
+        l->alloc = allocator_default();
+    }
+    // Growing in place (when the allocator can) saves a copy
+    u8* newbuf = allocator_realloc(l->alloc, (void*)l->data, l->alloc_size, newsize);
+    if (newbuf == NULL) {
+        LOG_MSG(error, "Couldn't expand list 0x%llX -> 0x%llX [alloc failure]\n", (unsigned long long)l->alloc_size, (unsigned long long)newsize);
+        return false;
+    }
+
+    // New space is zeroed, like it would be with a fresh list
+    const u64 old_size = (l->data != 0) ? l->alloc_size : 0;
+    memset(newbuf + old_size, 0x00, newsize - old_size);
+    CONTAINER_STATS_GROW(l->stats, old_size, newsize);
+    l->data = (uintptr_t)newbuf;
+    l->alloc_size = newsize;
+    return true;
+}
+
+bool list_reserve(list* l, csize count) {
+    if (l->element_size == 0 || count >= CSIZE_MAX / l->element_size) {
+        LOG_MSG(error, "Can't fit 0x%llX elements in a list\n", (unsigned long long)count);
+        return false;
+    }
+    // list_full() always keeps one slot open at the end, so we need room for
+    // an extra element to actually fit this many before the next growth.
+    const u64 min_size = ((u64)count + 1) * l->element_size;
+    if (min_size <= l->alloc_size) {
+        return true;
+    }
+    return list_grow(l, min_size);
+}
+
+void list_add(list* l, const void* data) {
+    // If there's no room, we need to realloc (or commit more pages)
+    if (list_full(*l) && !list_grow(l, (u64)l->alloc_size + l->element_size)) {
+        return;
     }
 
     // Put value in the next slot. Sorry it's kinda verbose
     void* next_slot = list_get_element(*l, l->end_idx++);
     memcpy(next_slot, data, l->element_size);
+    CONTAINER_STATS_COUNT(l->stats, l->end_idx);
 }
 
-void list_remove(list* l, u32 idx) {
+void list_add_many(list* l, const void* data, csize count) {
+    if (count == 0) {
+        return;
+    }
+    if (count > CSIZE_MAX - l->end_idx || !list_reserve(l, l->end_idx + count)) {
+        LOG_MSG(error, "Couldn't make room for 0x%llX more elements\n", (unsigned long long)count);
+        return;
+    }
+    const csize new_end = l->end_idx + count;
+
+    // Everything is contiguous, so it's just one big copy.
+    memcpy(list_get_element(*l, l->end_idx), data, (size_t)count * l->element_size);
+    l->end_idx = new_end;
+    CONTAINER_STATS_COUNT(l->stats, l->end_idx);
+}
+
+void list_remove(list* l, csize idx) {
     if (idx > l->end_idx || list_empty(*l)) {
         // Caller wants to remove an element that isn't used...
         return;
@@ -85,15 +382,189 @@ void list_remove_val(list* l, const void* data) {
     list_remove(l, idx);
 }
 
+void list_remove_ordered(list* l, csize idx) {
+    if (idx >= l->end_idx) {
+        // Caller wants to remove an element that isn't used...
+        return;
+    }
+
+    // Shift everything after the target down by one
+    const csize tail = l->end_idx - idx - 1;
+    memmove(list_get_element(*l, idx), list_get_element(*l, idx + 1), (size_t)tail * l->element_size);
+    CONTAINER_STATS_COMPACT(l->stats, (u64)tail * l->element_size);
+    l->end_idx--;
+}
+
+csize list_remove_indices(list* l, const csize* indices, csize count) {
+    csize write = 0; // Where the next kept element goes
+    csize read = 0;  // Start of the next run of kept elements
+    csize removed = 0;
+    for (csize i = 0; i < count; i++) {
+        const csize idx = indices[i];
+        // Skip anything out of bounds, out of order, or duplicated
+        if (idx >= l->end_idx || idx < read) {
+            continue;
+        }
+
+        // Everything between the last removal and this one is kept, and moved
+        // down in a single block.
+        const csize run = idx - read;
+        if (run > 0 && write != read) {
+            memmove(list_get_element(*l, write), list_get_element(*l, read), (size_t)run * l->element_size);
+            CONTAINER_STATS_COMPACT(l->stats, (u64)run * l->element_size);
+        }
+        write += run;
+        read = idx + 1;
+        removed++;
+    }
+
+    // Move the last run after the final removed element
+    const csize run = l->end_idx - read;
+    if (run > 0 && write != read) {
+        memmove(list_get_element(*l, write), list_get_element(*l, read), (size_t)run * l->element_size);
+        CONTAINER_STATS_COMPACT(l->stats, (u64)run * l->element_size);
+    }
+    l->end_idx = write + run;
+    return removed;
+}
+
+csize list_remove_if(list* l, list_predicate pred, void* ctx) {
+    const csize count = l->end_idx;
+    csize write = 0;
+    csize i = 0;
+    while (i < count) {
+        if (pred(list_get_element(*l, i), ctx)) {
+            i++;
+            continue;
+        }
+
+        // Find the end of this run of kept elements, then move it down as one
+        // block. The element that ends the run is removed, so skip past it.
+        csize run_end = i + 1;
+        while (run_end < count && !pred(list_get_element(*l, run_end), ctx)) {
+            run_end++;
+        }
+        const csize run = run_end - i;
+        if (write != i) {
+            memmove(list_get_element(*l, write), list_get_element(*l, i), (size_t)run * l->element_size);
+            CONTAINER_STATS_COMPACT(l->stats, (u64)run * l->element_size);
+        }
+        write += run;
+        i = run_end + 1;
+    }
+
+    l->end_idx = write;
+    return count - write;
+}
+
 void list_merge(list* dest, list src) {
-    for (u32 i = 0; i < src.end_idx; i++) {
-        const void* data = list_get_element(src, i);
-        list_add(dest, data);
+    if (src.element_size != dest->element_size) {
+        LOG_MSG(error, "Element sizes don't match (0x%llX vs. 0x%llX)\n", (unsigned long long)dest->element_size, (unsigned long long)src.element_size);
+        return;
+    }
+    list_add_many(dest, (const void*)src.data, src.end_idx);
+}
+
+#ifdef LIST_SIMD_SSE2
+/// Index of the lowest set bit. @p x must be non-zero.
+static inline u32 lowest_bit(u64 x) {
+#if defined(_MSC_VER)
+    unsigned long idx = 0;
+    _BitScanForward64(&idx, x);
+    return idx;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+/// @brief Turn a mask of matching bytes into a mask of matching elements.
+///
+/// Bit N of @p bytes is set if byte N matched. An element only matches if all
+/// of its bytes matched, so we AND every bit of each element's group down into
+/// the group's lowest bit, then throw away everything else. Groups always
+/// start at a multiple of @p width, which keeps us from matching a value that
+/// straddles two elements.
+static inline u64 whole_element_mask(u64 bytes, u32 width) {
+    for (u32 shift = 1; shift < width; shift *= 2) {
+        bytes &= bytes >> shift;
+    }
+    switch (width) {
+    case 2: return bytes & 0x5555555555555555;
+    case 4: return bytes & 0x1111111111111111;
+    case 8: return bytes & 0x0101010101010101;
+    case 16: return bytes & 0x0001000100010001;
+    default: return bytes;
     }
 }
 
+/// @brief Vectorized version of list_find() for 1, 2, 4, 8, and 16 byte
+/// elements.
+///
+/// All widths use the same byte-wise compare, so we only need one kernel. The
+/// needle is repeated to fill a whole vector, and since every block starts at
+/// a multiple of 64 bytes (which every supported width divides) the lanes
+/// always line up with elements.
+static s64 list_find_simd(list l, const void* data) {
+    const u32 width = l.element_size;
+    u8 pattern[32];
+    for (u32 i = 0; i < sizeof(pattern); i += width) {
+        memcpy(&pattern[i], data, width);
+    }
+
+    const u8* base = (const u8*)l.data;
+    const u64 total = (u64)l.end_idx * width;
+    u64 pos = 0;
+
+#if defined(LIST_SIMD_AVX2)
+    const __m256i needle = _mm256_loadu_si256((const __m256i*)pattern);
+    for (; pos + 64 <= total; pos += 64) {
+        const __m256i lo = _mm256_loadu_si256((const __m256i*)&base[pos]);
+        const __m256i hi = _mm256_loadu_si256((const __m256i*)&base[pos + 32]);
+        const u64 mask_lo = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle));
+        const u64 mask_hi = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle));
+        const u64 matches = whole_element_mask(mask_lo | (mask_hi << 32), width);
+        if (matches != 0) {
+            return (pos + lowest_bit(matches)) / width;
+        }
+    }
+#else
+    const __m128i needle = _mm_loadu_si128((const __m128i*)pattern);
+    for (; pos + 64 <= total; pos += 64) {
+        u64 mask = 0;
+        for (u32 i = 0; i < 4; i++) {
+            const __m128i block = _mm_loadu_si128((const __m128i*)&base[pos + (i * 16)]);
+            mask |= (u64)(u16)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)) << (i * 16);
+        }
+        const u64 matches = whole_element_mask(mask, width);
+        if (matches != 0) {
+            return (pos + lowest_bit(matches)) / width;
+        }
+    }
+#endif
+
+    // Less than a full block left, finish up one element at a time
+    for (; pos < total; pos += width) {
+        if (memcmp(&base[pos], data, width) == 0) {
+            return pos / width;
+        }
+    }
+    return -1;
+}
+#endif // LIST_SIMD_SSE2
+
 s64 list_find(list l, const void* data) {
-    for (u32 i = 0; i < l.end_idx; i++) {
+#ifdef LIST_SIMD_SSE2
+    switch (l.element_size) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+    case 16:
+        return list_find_simd(l, data);
+    }
+#endif
+
+    for (csize i = 0; i < l.end_idx; i++) {
         void* element = list_get_element(l, i);
         if (memcmp(data, element, l.element_size) == 0) {
             // Found it!
@@ -110,10 +581,60 @@ bool list_contains(list l, const void* data) {
 }
 
 void list_clear(list* l) {
-    memset((void*)l->data, 0x00, l->alloc_size);
     l->end_idx = 0;
 }
 
+void list_clear_zero(list* l) {
+    if ((void*)l->data != NULL) {
+        memset((void*)l->data, 0x00, l->alloc_size);
+    }
+    l->end_idx = 0;
+}
+
+bool list_shrink_to_fit(list* l) {
+    if (l->reserve_size != 0) {
+        return false;
+    }
+
+    if (l->element_size == 0 || l->end_idx >= CSIZE_MAX / l->element_size) {
+        LOG_MSG(error, "Can't fit 0x%llX elements in a list\n", (unsigned long long)l->end_idx + 1);
+        return false;
+    }
+    // Keep the one open slot list_full() expects, so the next add works as
+    // usual.
+    const u64 newsize = ((u64)l->end_idx + 1) * l->element_size;
+    if (newsize >= l->alloc_size) {
+        return true; // Already as small as it gets
+    }
+    if (l->file != NULL) {
+        return list_resize_file(l, newsize);
+    }
+    void* newbuf = allocator_realloc(l->alloc, (void*)l->data, l->alloc_size, newsize);
+    if (newbuf == NULL) {
+        LOG_MSG(error, "Couldn't shrink list 0x%llX -> 0x%llX [alloc failure]\n", (unsigned long long)l->alloc_size, (unsigned long long)newsize);
+        return false;
+    }
+    l->data = (uintptr_t)newbuf;
+    l->alloc_size = newsize;
+    return true;
+}
+
+void list_set_growth(list* l, float factor) {
+    l->growth_factor = (factor > 1.0f) ? factor : LIST_DEFAULT_GROWTH;
+}
+
 bool list_empty(list l) {
     return (l.end_idx == 0);
 }
+
+container_stats list_stats(list l) {
+#ifdef BOBTAIL_CONTAINER_STATS
+    container_stats stats = l.stats;
+    // Lists keep one slot open at the end
+    stats.suggested_init_size = ((u64)stats.peak_count + 1) * l.element_size;
+    return stats;
+#else
+    (void)l;
+    return (container_stats){0};
+#endif
+}
@@ -5,12 +5,20 @@
 /// @warning Don't keep pointers / indices to elements of the list for any
 /// longer than necessary! They are liable to point to different data or
 /// freed/invalid memory if the list is modified. Any function taking a pointer
-/// to the list can and will modify any part of it.
+/// to the list can and will modify any part of it. If you need stable
+/// pointers, use list_create_reserved() or a segmented list (seglist.h).
 /// @sa queue.h
+/// @sa seglist.h
 
 #include <stddef.h>
 #include <stdbool.h>
 #include "int.h"
+#include "fmap.h"
+#include "allocator.h"
+#include "container_stats.h"
+
+/// Growth factor used by lists that don't set their own
+#define LIST_DEFAULT_GROWTH 1.5f
 
 /// @brief An automatically expanding dynamic list
 /// @warning Don't keep pointers / indices to elements of the list for any
@@ -25,14 +33,39 @@ typedef struct {
     /// accidentally be dereferenced.
     uintptr_t data;
     /// Current buffer size
-    u32 alloc_size;
+    csize alloc_size;
     /// @brief Index of the next open slot in the array (not the last element!)
     ///
     /// @warning This isn't the index of the last element! It could be an
     /// invalid index, or depending on the circumstances, invalid memory.
-    u32 end_idx;
+    csize end_idx;
     /// Size of each array element
-    u32 element_size;
+    csize element_size;
+    /// @brief Size of the reserved address range for lists made with
+    /// @ref list_create_reserved(), or 0 for normal heap-backed lists.
+    ///
+    /// When this is non-zero, @ref list.alloc_size is the number of bytes
+    /// committed so far, and the list grows in place instead of copying.
+    u64 reserve_size;
+    /// @brief How much the buffer is multiplied by when it's full.
+    ///
+    /// Anything 1.0 or below (like the 0 in a zero-initialized list) means the
+    /// default of @ref LIST_DEFAULT_GROWTH.
+    /// @sa list_set_growth
+    float growth_factor;
+    /// @brief Backing file for lists made with @ref list_map_file(), or NULL
+    /// for normal lists.
+    fmap* file;
+    /// @brief Allocator for the backing buffer.
+    ///
+    /// NULL (like in a zero-initialized list) means the default allocator at
+    /// the time of the first allocation.
+    /// @sa allocator.h
+    const allocator* alloc;
+#ifdef BOBTAIL_CONTAINER_STATS
+    /// Growth counters, see container_stats.h
+    container_stats stats;
+#endif
 }list;
 
 /// Create a list.
@@ -46,10 +79,57 @@ typedef struct {
 /// @return A newly initialized dynamic list.
 /// @note This allocates memory!
 /// @sa list_destroy
-list list_create(u32 init_size, u32 element_size);
+list list_create(csize init_size, csize element_size);
+
+/// @brief Create a list that gets its memory from a specific allocator.
+/// @param a Allocator for the backing buffer, or NULL for the default. This
+/// isn't copied, so it has to outlive the list.
+/// @sa list_create
+list list_create_alloc(csize init_size, csize element_size, const allocator* a);
+
+/// @brief Create a list that grows in place inside a reserved address range.
+///
+/// Instead of reallocating & copying when it fills up, the list reserves
+/// @p max_bytes of address space up front with @ref vmem_reserve() and
+/// commits more pages at the end as they're needed. Since the buffer never
+/// moves, pointers to elements stay valid when the list grows (but not when
+/// elements are removed).
+///
+/// @param max_bytes Maximum size the list can ever grow to. This only costs
+/// address space, so it's fine to be generous.
+/// @param element_size Size of each element, see @ref list_create()
+///
+/// @return A newly initialized list, with a NULL @ref list.data on failure.
+/// @note Adding elements past @p max_bytes fails with an error message.
+/// @sa list_destroy
+list list_create_reserved(u64 max_bytes, csize element_size);
+
+/// @brief Create a list backed by a memory-mapped file.
+///
+/// The file starts with a small header recording the element size & count,
+/// followed by the elements as a plain array. If the file already holds a
+/// list, its elements are available right away without any loading or
+/// copying, and the OS page cache does all the I/O. Otherwise, a new list file
+/// is created.
+///
+/// Growing the list extends the file. The element count in the header is
+/// updated by @ref list_sync() and @ref list_destroy().
+/// @param path Path of the list file
+/// @param element_size Size of each element. When opening an existing list
+/// file, this has to match the size it was created with.
+/// @return A list using the file, with a NULL @ref list.data on failure.
+/// @sa list_sync
+list list_map_file(const char* path, csize element_size);
+
+/// @brief Write a file-backed list to disk, and wait for it to finish.
+/// @return Whether it succeeded. Always false for lists not made with
+/// @ref list_map_file().
+bool list_sync(list* l);
 
 /// @brief Free list data & fill all fields with 0
 ///
+/// For lists made with @ref list_map_file(), this saves the element count and
+/// closes the file (which is kept on disk).
 /// @param l List to destroy
 /// @sa list_create
 void list_destroy(list* l);
@@ -62,23 +142,72 @@ void list_destroy(list* l);
 /// @sa list_create()
 void list_add(list* l, const void* data);
 
+/// @brief Append several elements to the list at once.
+///
+/// This grows the list at most once, then copies all the data in one go, so
+/// it's much faster than calling @ref list_add() in a loop.
+/// @param l The list to modify
+/// @param data Array of elements to append. Must be at least
+/// (@p count * @ref list.element_size) bytes
+/// @param count Number of elements to append
+/// @note This allocates memory if the list can't hold the new data.
+void list_add_many(list* l, const void* data, csize count);
+
+/// @brief Make sure the list can hold at least @p count elements without
+/// growing again.
+///
+/// Useful to pre-size a list before adding lots of elements, so you don't go
+/// through a long chain of reallocations.
+/// @param l The list to modify
+/// @param count Total number of elements the list should be able to hold
+/// @return Whether the list has enough room
+/// @note This allocates memory if the list is too small.
+bool list_reserve(list* l, csize count);
+
 /// @brief Retrieve an element from the list.
 ///
 /// @return Generic pointer to the element. This is our only option in C, since
 /// the @ref list structure is generic. You'll have to cast to the appropriate
 /// pointer type.
-void* list_get_element(list l, u32 idx);
+void* list_get_element(list l, csize idx);
 
-/// Reset list to initial state and fill buffer with 0. Does not free buffer.
+/// @brief Remove every element from the list. Does not free buffer.
+///
+/// This only resets the element count, so it's O(1) no matter how big the
+/// list is. Old data is left behind in the buffer, use @ref list_clear_zero()
+/// if that matters.
 void list_clear(list* l);
 
+/// @brief Remove every element and fill the whole buffer with 0. Does not free
+/// buffer.
+/// @sa list_clear
+void list_clear_zero(list* l);
+
+/// @brief Shrink the buffer down to fit the current elements.
+///
+/// Useful after a list is done growing & will stick around for a while.
+/// @return Whether the buffer could be shrunk. Lists made with
+/// @ref list_create_reserved() can't give back committed pages, so this does
+/// nothing & returns false for them.
+/// @note This allocates memory!
+bool list_shrink_to_fit(list* l);
+
+/// @brief Set how much the list's buffer grows by when it's full
+///
+/// Bigger factors mean fewer reallocations but more wasted space. If you know
+/// roughly how big the list will get, @ref list_reserve() is even better.
+/// @param l The list to modify
+/// @param factor Multiplier applied to the buffer size, which has to be over
+/// 1.0. Anything else resets to @ref LIST_DEFAULT_GROWTH.
+void list_set_growth(list* l, float factor);
+
 /// @brief Remove an element from the list.
 ///
 /// @param l List to modify
 /// @param idx Index of element to remove
 /// @note This doesn't shift the entire list over by one element, as you might
 /// expect. Don't make any assumptions about element order.
-void list_remove(list* l, u32 idx);
+void list_remove(list* l, csize idx);
 
 /// @brief Find and remove the first occurance of a value from the list.
 ///
@@ -88,13 +217,54 @@ void list_remove(list* l, u32 idx);
 /// @sa list_find
 void list_remove_val(list* l, const void* data);
 
+/// @brief Remove an element, keeping the rest in the same order.
+///
+/// Everything after the element is shifted down, so this is O(n) unlike
+/// @ref list_remove().
+/// @param l List to modify
+/// @param idx Index of element to remove
+void list_remove_ordered(list* l, csize idx);
+
+/// @brief Remove a batch of elements, keeping the rest in the same order.
+///
+/// This does one pass over the list, moving each run of kept elements with a
+/// single memmove(), so it's much faster than removing one at a time.
+/// @param l List to modify
+/// @param indices Indices of elements to remove, sorted in ascending order.
+/// Duplicates and out of bounds indices are ignored.
+/// @param count Number of indices
+/// @return Number of elements removed
+csize list_remove_indices(list* l, const csize* indices, csize count);
+
+/// @brief Decide whether an element should be removed.
+/// @param element Pointer to the element
+/// @param ctx Whatever context pointer was passed to @ref list_remove_if()
+/// @return true to remove the element
+typedef bool (*list_predicate)(const void* element, void* ctx);
+
+/// @brief Remove every element matching a predicate, keeping the rest in the
+/// same order.
+///
+/// The list is compacted in a single pass, moving each run of kept elements
+/// with one memmove(). The predicate is called exactly once per element, in
+/// order.
+/// @param l List to modify
+/// @param pred Returns true for elements that should be removed
+/// @param ctx Passed through to @p pred
+/// @return Number of elements removed
+csize list_remove_if(list* l, list_predicate pred, void* ctx);
+
 /// @brief Append every element of @p src onto @p dest (duplicates are allowed)
 /// @param dest List to append to
 /// @param src List to copy data from
 /// @note This allocates memory if the @p dest list can't hold the new data.
+/// Both lists must have the same @ref list.element_size.
 void list_merge(list* dest, list src);
 
 /// @brief Search for a value and return its index
+///
+/// Lists with 1, 2, 4, 8 or 16 byte elements are searched with SSE2 (or AVX2,
+/// when the compiler is allowed to use it) on x86.
 /// @param l List to search
 /// @param data Data to search for. Must be at least @ref list.element_size.
 /// @return Index of the data, or -1 on failure.
@@ -110,4 +280,10 @@ bool list_contains(list l, const void* data);
 /// @brief Whether the list is empty
 bool list_empty(list l);
 
+/// @brief Get the growth counters for a list.
+/// @return The counters, or all zeros if the library wasn't built with
+/// BOBTAIL_CONTAINER_STATS.
+/// @sa container_stats.h
+container_stats list_stats(list l);
+
 #endif // #ifndef LIST_H
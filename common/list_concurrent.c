@@ -0,0 +1,159 @@
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "logging.h"
+#include "list_concurrent.h"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+/// Index of the highest set bit. @p x must be non-zero.
+static inline u32 highest_bit(u64 x) {
+#if defined(_MSC_VER)
+    unsigned long idx = 0;
+    _BitScanReverse64(&idx, x);
+    return idx;
+#else
+    return 63 - __builtin_clzll(x);
+#endif
+}
+
+/// Where an element lives
+typedef struct {
+    u32 chunk;
+    csize offset;
+}slot_pos;
+
+/// @brief Find which chunk an index is in, and where in that chunk.
+///
+/// Chunk k starts at index (base << k) - base. Adding base to the index lines
+/// the chunk boundaries up with powers of 2, so the chunk is just the highest
+/// set bit.
+static inline slot_pos slot_locate(const list_concurrent* l, csize idx) {
+    const u64 shifted = (u64)idx + ((u64)1 << l->base_shift);
+    const u32 chunk = highest_bit(shifted) - l->base_shift;
+    return (slot_pos) {
+        .chunk = chunk,
+        .offset = shifted - ((u64)1 << highest_bit(shifted)),
+    };
+}
+
+static inline csize chunk_elements(const list_concurrent* l, u32 chunk) {
+    return (csize)1 << (l->base_shift + chunk);
+}
+
+/// Size of the published flags at the start of a chunk, padded so elements
+/// stay nicely aligned.
+static inline csize chunk_flags_size(const list_concurrent* l, u32 chunk) {
+    return ALIGN_UP(chunk_elements(l, chunk) - 1, 16);
+}
+
+/// @brief Get a chunk, allocating it if nobody has yet.
+///
+/// If several threads race to allocate the same chunk, they all allocate one
+/// but only the first to publish it wins. The losers free theirs & use the
+/// winner's, so no lock is needed.
+static u8* chunk_get(list_concurrent* l, u32 chunk) {
+    u8* existing = atomic_load_explicit(&l->chunks[chunk], memory_order_acquire);
+    if (existing != NULL) {
+        return existing;
+    }
+
+    const u64 size = (u64)chunk_flags_size(l, chunk) + ((u64)chunk_elements(l, chunk) * l->element_size);
+    u8* fresh = allocator_calloc(l->alloc, size);
+    if (fresh == NULL) {
+        LOG_MSG(error, "Couldn't allocate chunk %d [0x%llX bytes]\n", chunk, (unsigned long long)size);
+        return NULL;
+    }
+    if (atomic_compare_exchange_strong_explicit(&l->chunks[chunk], &existing, fresh, memory_order_acq_rel, memory_order_acquire)) {
+        return fresh;
+    }
+
+    // Someone beat us to it
+    allocator_free(l->alloc, fresh);
+    return existing;
+}
+
+list_concurrent list_concurrent_create(csize first_chunk_elements, csize element_size) {
+    // Round up to a power of 2
+    u8 shift = 0;
+    while (((csize)1 << shift) < first_chunk_elements && shift < (sizeof(csize) * 8) - 1) {
+        shift++;
+    }
+
+    return (list_concurrent) {
+        .element_size = element_size,
+        .base_shift = shift,
+        .alloc = allocator_default(),
+    };
+}
+
+void list_concurrent_destroy(list_concurrent* l) {
+    for (u32 i = 0; i < LIST_CONCURRENT_MAX_CHUNKS; i++) {
+        allocator_free(l->alloc, atomic_load_explicit(&l->chunks[i], memory_order_relaxed));
+    }
+    *l = (list_concurrent){0};
+}
+
+s64 list_concurrent_add(list_concurrent* l, const void* data) {
+    const csize idx = atomic_fetch_add_explicit(&l->reserved, 1, memory_order_relaxed);
+    const slot_pos pos = slot_locate(l, idx);
+    if (idx == CSIZE_MAX || pos.chunk >= LIST_CONCURRENT_MAX_CHUNKS) {
+        LOG_MSG(error, "List is full\n");
+        return -1;
+    }
+
+    u8* chunk = chunk_get(l, pos.chunk);
+    if (chunk == NULL) {
+        // This slot will never be published, so readers will stop here.
+        return -1;
+    }
+
+    u8* element = chunk + chunk_flags_size(l, pos.chunk) + (pos.offset * l->element_size);
+    memcpy(element, data, l->element_size);
+
+    // Release makes sure the element data is visible before the flag is
+    // set, pairs with the acquire load in the readers
+    _Atomic(u8)* flag = (_Atomic(u8)*)&chunk[pos.offset];
+    atomic_store_explicit(flag, 1, memory_order_release);
+    return idx;
+}
+
+csize list_concurrent_count(list_concurrent* l) {
+    csize count = atomic_load_explicit(&l->published, memory_order_acquire);
+    const csize reserved = atomic_load_explicit(&l->reserved, memory_order_relaxed);
+
+    // Walk forward from the last known prefix until we hit a slot that's
+    // still being written.
+    while (count < reserved) {
+        const slot_pos pos = slot_locate(l, count);
+        if (pos.chunk >= LIST_CONCURRENT_MAX_CHUNKS) {
+            break;
+        }
+        u8* chunk = atomic_load_explicit(&l->chunks[pos.chunk], memory_order_acquire);
+        if (chunk == NULL) {
+            break;
+        }
+        _Atomic(u8)* flag = (_Atomic(u8)*)&chunk[pos.offset];
+        if (atomic_load_explicit(flag, memory_order_acquire) == 0) {
+            break;
+        }
+        count++;
+    }
+
+    // Share what we found so other readers can skip ahead. Another reader may
+    // have gotten further already, in which case we leave theirs alone.
+    csize known = atomic_load_explicit(&l->published, memory_order_relaxed);
+    while (known < count && !atomic_compare_exchange_weak_explicit(&l->published, &known, count, memory_order_release, memory_order_relaxed)) {
+    }
+    return count;
+}
+
+void* list_concurrent_get_element(list_concurrent* l, csize idx) {
+    const slot_pos pos = slot_locate(l, idx);
+    u8* chunk = atomic_load_explicit(&l->chunks[pos.chunk], memory_order_acquire);
+    return chunk + chunk_flags_size(l, pos.chunk) + (pos.offset * l->element_size);
+}
@@ -0,0 +1,88 @@
+#ifndef LIST_CONCURRENT_H
+#define LIST_CONCURRENT_H
+/// @file list_concurrent.h
+/// @brief Lock-free append-only list for many producer threads
+///
+/// Any number of threads can append at the same time without a lock. Each add
+/// claims a slot with an atomic fetch-add, copies its data in, then marks that
+/// slot as published. Readers can run alongside the producers, and always see
+/// a consistent prefix of fully written elements.
+///
+/// Elements are stored in chunks that double in size (the first chunk holds
+/// N elements, the next 2N, then 4N...). Chunks are never moved or freed
+/// while the list is alive, so growing never stops readers, and pointers to
+/// elements stay valid forever.
+/// @sa list.h
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "allocator.h"
+
+enum {
+    /// Max number of chunks. Since they double in size, this is plenty to
+    /// cover the whole @ref csize range.
+    LIST_CONCURRENT_MAX_CHUNKS = sizeof(csize) * 8,
+};
+
+/// @brief A lock-free, append-only list
+///
+/// @warning Create & destroy aren't thread-safe, everything else is.
+typedef struct {
+    /// @brief Chunk k holds (1 << (@ref list_concurrent.base_shift + k))
+    /// elements.
+    ///
+    /// Each chunk is a byte array of "published" flags (one per element),
+    /// followed by the elements themselves.
+    _Atomic(u8*) chunks[LIST_CONCURRENT_MAX_CHUNKS];
+    /// Number of slots handed out to producers so far
+    _Atomic(csize) reserved;
+    /// @brief Known length of the published prefix.
+    ///
+    /// This is a cache so readers don't have to re-check flags from the start.
+    _Atomic(csize) published;
+    /// Size of each element
+    csize element_size;
+    /// log2 of the number of elements in the first chunk
+    u8 base_shift;
+    /// Where chunks come from. @ref list_concurrent_create() picks the default
+    /// allocator, so chunks are freed by the same one even if the default
+    /// changes later.
+    /// @sa allocator.h
+    const allocator* alloc;
+}list_concurrent;
+
+/// @brief Create a concurrent list
+/// @param first_chunk_elements Number of elements in the first chunk (rounded
+/// up to a power of 2). Every chunk after it is twice as big as the last.
+/// @param element_size Size of each element
+/// @return A newly initialized list. No memory is allocated until the first
+/// element is added.
+/// @sa list_concurrent_destroy
+list_concurrent list_concurrent_create(csize first_chunk_elements, csize element_size);
+
+/// @brief Free all chunks & fill all fields with 0.
+/// @warning No other threads can be using the list.
+void list_concurrent_destroy(list_concurrent* l);
+
+/// @brief Append an element. Safe to call from any number of threads.
+/// @param l The list to modify
+/// @param data Data to append. Must be at least
+/// @ref list_concurrent.element_size bytes
+/// @return Index of the new element, or -1 on failure.
+/// @note This allocates memory when a new chunk is needed.
+s64 list_concurrent_add(list_concurrent* l, const void* data);
+
+/// @brief Number of elements that are fully written & safe to read.
+///
+/// Every index below this number can be read with
+/// @ref list_concurrent_get_element(). Elements still being written by
+/// producers aren't counted, even if later ones are already done.
+csize list_concurrent_count(list_concurrent* l);
+
+/// @brief Retrieve an element from the list.
+/// @warning Only indices below @ref list_concurrent_count() are safe to read.
+void* list_concurrent_get_element(list_concurrent* l, csize idx);
+
+#endif // #ifndef LIST_CONCURRENT_H
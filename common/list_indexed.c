@@ -0,0 +1,203 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "int.h"
+#include "logging.h"
+#include "list.h"
+#include "list_indexed.h"
+
+enum {
+    /// Number of hash slots a new index starts with
+    INDEX_MIN_SLOTS = 16,
+};
+
+/// Finish off a hash by mixing all the bits together (splitmix64 finalizer)
+static inline u64 hash_mix(u64 x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EB;
+    x ^= x >> 31;
+    return x;
+}
+
+/// Hash an element's bytes. Common integer sizes skip the byte loop.
+static u64 hash_element(const void* data, csize size) {
+    if (size == sizeof(u64)) {
+        u64 val = 0;
+        memcpy(&val, data, sizeof(val));
+        return hash_mix(val);
+    }
+    if (size == sizeof(u32)) {
+        u32 val = 0;
+        memcpy(&val, data, sizeof(val));
+        return hash_mix(val);
+    }
+
+    // FNV-1a for everything else
+    const u8* bytes = data;
+    u64 hash = 0xCBF29CE484222325;
+    for (csize i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3;
+    }
+    return hash_mix(hash);
+}
+
+/// Home slot for some element data
+static inline csize home_slot(list_indexed l, const void* data) {
+    return hash_element(data, l.items.element_size) & (l.slot_count - 1);
+}
+
+/// Put an element index into the first free slot after its home slot
+static void index_insert(list_indexed* l, csize idx) {
+    const csize mask = l->slot_count - 1;
+    csize pos = home_slot(*l, list_get_element(l->items, idx));
+    while (l->slots[pos] != 0) {
+        pos = (pos + 1) & mask;
+    }
+    l->slots[pos] = idx + 1;
+}
+
+/// Find the slot holding a specific element index. The index must exist.
+static csize index_slot_of(list_indexed l, csize idx) {
+    const csize mask = l.slot_count - 1;
+    csize pos = home_slot(l, list_get_element(l.items, idx));
+    while (l.slots[pos] != idx + 1) {
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+/// @brief Empty a slot without breaking any probe chains.
+///
+/// Instead of tombstones, we use backward shift deletion: everything after the
+/// hole that could legally live in it gets shifted back, until we hit an empty
+/// slot. This keeps lookups fast no matter how many removals happen.
+static void index_delete(list_indexed* l, csize pos) {
+    const csize mask = l->slot_count - 1;
+    csize hole = pos;
+    csize next = (pos + 1) & mask;
+    while (l->slots[next] != 0) {
+        const csize home = home_slot(*l, list_get_element(l->items, l->slots[next] - 1));
+        // Move the entry back if its home isn't between the hole and where it
+        // is now (wrapping around the table).
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            l->slots[hole] = l->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    l->slots[hole] = 0;
+}
+
+/// Rebuild the index with a new number of slots (must be a power of 2)
+static bool index_rebuild(list_indexed* l, csize slot_count) {
+    // The slots always come from the same allocator as the items
+    if (l->items.alloc == NULL) {
+        l->items.alloc = allocator_default();
+    }
+    csize* slots = allocator_calloc(l->items.alloc, (size_t)slot_count * sizeof(*slots));
+    if (slots == NULL) {
+        LOG_MSG(error, "Couldn't expand index to 0x%llX slots [alloc failure]\n", (unsigned long long)slot_count);
+        return false;
+    }
+    allocator_free(l->items.alloc, l->slots);
+    l->slots = slots;
+    l->slot_count = slot_count;
+
+    for (csize i = 0; i < l->items.end_idx; i++) {
+        index_insert(l, i);
+    }
+    return true;
+}
+
+list_indexed list_indexed_create(csize init_size, csize element_size) {
+    const list items = list_create(init_size, element_size);
+    return (list_indexed) {
+        .items = items,
+        .slots = allocator_calloc(items.alloc, INDEX_MIN_SLOTS * sizeof(csize)),
+        .slot_count = INDEX_MIN_SLOTS,
+    };
+}
+
+void list_indexed_destroy(list_indexed* l) {
+    csize* slots = l->slots;
+    const allocator* a = l->items.alloc;
+    list_destroy(&l->items);
+    *l = (list_indexed){0};
+    allocator_free(a, slots);
+}
+
+void list_indexed_add(list_indexed* l, const void* data) {
+    // Keep the load factor under 75%, so probe chains stay short
+    const u64 new_count = (u64)l->items.end_idx + 1;
+    if (l->slots == NULL || new_count * 4 > (u64)l->slot_count * 3) {
+        const csize slot_count = MAX(l->slot_count * 2, INDEX_MIN_SLOTS);
+        if (!index_rebuild(l, slot_count)) {
+            return;
+        }
+    }
+
+    const csize old_end = l->items.end_idx;
+    list_add(&l->items, data);
+    if (l->items.end_idx == old_end) {
+        return; // The list couldn't grow, error was already printed.
+    }
+    index_insert(l, old_end);
+}
+
+void list_indexed_remove(list_indexed* l, csize idx) {
+    if (idx >= l->items.end_idx) {
+        // Caller wants to remove an element that isn't used...
+        return;
+    }
+
+    // The list moves its last element into the removed slot, so the index
+    // entry pointing at the last element has to follow it.
+    const csize last = l->items.end_idx - 1;
+    index_delete(l, index_slot_of(*l, idx));
+    if (idx != last) {
+        l->slots[index_slot_of(*l, last)] = idx + 1;
+    }
+    list_remove(&l->items, idx);
+}
+
+void list_indexed_remove_val(list_indexed* l, const void* data) {
+    const s64 idx = list_indexed_find(*l, data);
+    if (idx == -1) {
+        return;
+    }
+    list_indexed_remove(l, idx);
+}
+
+s64 list_indexed_find(list_indexed l, const void* data) {
+    if (l.slots == NULL) {
+        return -1;
+    }
+
+    const csize mask = l.slot_count - 1;
+    csize pos = home_slot(l, data);
+    while (l.slots[pos] != 0) {
+        const csize idx = l.slots[pos] - 1;
+        if (memcmp(list_get_element(l.items, idx), data, l.items.element_size) == 0) {
+            return idx;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    // Hit an empty slot, so it's not here
+    return -1;
+}
+
+bool list_indexed_contains(list_indexed l, const void* data) {
+    return list_indexed_find(l, data) != -1;
+}
+
+void list_indexed_clear(list_indexed* l) {
+    list_clear(&l->items);
+    if (l->slots != NULL) {
+        memset(l->slots, 0x00, l->slot_count * sizeof(*l->slots));
+    }
+}
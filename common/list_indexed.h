@@ -0,0 +1,81 @@
+#ifndef LIST_INDEXED_H
+#define LIST_INDEXED_H
+/// @file list_indexed.h
+/// @brief A dynamic list with a hash index for O(1) searching
+///
+/// This is a normal @ref list, plus an open addressing hash table mapping each
+/// element's bytes to its index. Searching is expected O(1) instead of a linear
+/// scan, which is a big deal when deduplicating inside a loop.
+///
+/// @warning Same rules as the normal list: don't keep pointers / indices to
+/// elements for any longer than necessary, since adding or removing can move
+/// things around.
+/// @sa list.h
+
+#include <stdbool.h>
+
+#include "int.h"
+#include "list.h"
+
+/// @brief A dynamic list with a hash index attached
+///
+/// @warning Reading from @ref list_indexed.items directly is fine, but only
+/// modify it through the list_indexed functions, or the index will go stale.
+typedef struct {
+    /// The underlying list holding all the elements
+    list items;
+    /// @brief Hash table of element indices
+    ///
+    /// Each slot holds (index + 1) of an element, so that 0 can mean the slot
+    /// is empty. Collisions are handled with linear probing.
+    csize* slots;
+    /// Number of hash table slots. This is always a power of 2.
+    csize slot_count;
+}list_indexed;
+
+/// @brief Create an indexed list.
+/// @param init_size The initial allocation size in bytes of the list itself
+/// @param element_size Size of each element, see @ref list_create()
+/// @return A newly initialized indexed list
+/// @note This allocates memory!
+/// @sa list_indexed_destroy
+list_indexed list_indexed_create(csize init_size, csize element_size);
+
+/// @brief Free the list & its index, and fill all fields with 0
+void list_indexed_destroy(list_indexed* l);
+
+/// @brief Append an element to the list and add it to the index.
+/// @param l The list to modify
+/// @param data The data to append. Must be at least
+/// @ref list.element_size bytes
+/// @note This allocates memory if the list or the index are full.
+void list_indexed_add(list_indexed* l, const void* data);
+
+/// @brief Remove an element, keeping the index up to date.
+///
+/// Just like @ref list_remove(), the last element is moved into the removed
+/// slot, so don't make any assumptions about element order.
+/// @param l List to modify
+/// @param idx Index of element to remove
+void list_indexed_remove(list_indexed* l, csize idx);
+
+/// @brief Find and remove an occurance of a value from the list.
+/// @sa list_indexed_remove
+void list_indexed_remove_val(list_indexed* l, const void* data);
+
+/// @brief Search for a value using the hash index (expected O(1))
+/// @param l List to search
+/// @param data Data to search for. Must be at least @ref list.element_size.
+/// @return Index of the data, or -1 on failure.
+/// @note If the list has duplicates, this returns any one of them (not
+/// necessarily the first, like @ref list_find() does).
+s64 list_indexed_find(list_indexed l, const void* data);
+
+/// @brief Whether the list contains a certain value (expected O(1))
+/// @sa list_indexed_find
+bool list_indexed_contains(list_indexed l, const void* data);
+
+/// Remove every element & empty the index. Does not free anything.
+void list_indexed_clear(list_indexed* l);
+
+#endif // #ifndef LIST_INDEXED_H
@@ -0,0 +1,311 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "int.h"
+#include "logging.h"
+#include "thread.h"
+#include "job.h"
+#include "list.h"
+#include "list_sort.h"
+
+enum {
+    /// Max number of threads used for one sort
+    SORT_MAX_THREADS = 16,
+    /// One bucket for each possible byte value
+    RADIX_BUCKETS = 256,
+};
+
+/// How many threads to use to sort this many elements
+static u32 sort_thread_count(csize count) {
+    if (count < LIST_SORT_PARALLEL_MIN) {
+        return 1;
+    }
+    return MIN(thread_cpu_count(), SORT_MAX_THREADS);
+}
+
+/// @brief Run @p proc once for each element of the @p args array, in parallel.
+///
+/// The first one runs on the calling thread, the rest go to the job system.
+static void run_parallel(job_proc proc, void* args, size_t arg_size, u32 count) {
+    job_group group = {0};
+    for (u32 i = 1; i < count; i++) {
+        job_submit(&group, proc, (u8*)args + (i * arg_size));
+    }
+    proc(args);
+    job_wait(&group);
+}
+
+/// Copy one element. Common sizes get a fixed-size copy the compiler can inline.
+static inline void copy_element(void* dst, const void* src, csize size) {
+    switch (size) {
+    case 2: memcpy(dst, src, 2); break;
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    default: memcpy(dst, src, size); break;
+    }
+}
+
+// ---- Comparison sort ----
+// Each thread qsort()s one piece of the list, then pairs of sorted pieces are
+// merged together (also in parallel) until there's only one left.
+
+typedef struct {
+    const u8* src;
+    u8* dst;
+    csize element_size;
+    list_compare cmp;
+    /// Element range of the left & right halves: [begin, mid) and [mid, end)
+    csize begin;
+    csize mid;
+    csize end;
+}sort_task;
+
+static void sort_piece(void* arg) {
+    sort_task* task = arg;
+    qsort(task->dst + (task->begin * task->element_size), task->end - task->begin, task->element_size, task->cmp);
+}
+
+static void merge_pieces(void* arg) {
+    const sort_task* task = arg;
+    const csize size = task->element_size;
+    csize left = task->begin;
+    csize right = task->mid;
+    u8* out = task->dst + (task->begin * size);
+
+    while (left < task->mid && right < task->end) {
+        const u8* a = task->src + (left * size);
+        const u8* b = task->src + (right * size);
+        // Taking from the left on ties keeps the merge stable
+        if (task->cmp(a, b) <= 0) {
+            copy_element(out, a, size);
+            left++;
+        }
+        else {
+            copy_element(out, b, size);
+            right++;
+        }
+        out += size;
+    }
+
+    // One side ran out, the rest of the other is already in order
+    memcpy(out, task->src + (left * size), (task->mid - left) * size);
+    out += (task->mid - left) * size;
+    memcpy(out, task->src + (right * size), (task->end - right) * size);
+}
+
+void list_sort(list* l, list_compare cmp) {
+    const csize count = l->end_idx;
+    const u32 pieces = sort_thread_count(count);
+    if (pieces <= 1) {
+        qsort((void*)l->data, count, l->element_size, cmp);
+        return;
+    }
+
+    u8* scratch = allocator_alloc(l->alloc, (size_t)count * l->element_size);
+    if (scratch == NULL) {
+        LOG_MSG(warning, "Couldn't allocate sort buffer, sorting on 1 thread\n");
+        qsort((void*)l->data, count, l->element_size, cmp);
+        return;
+    }
+
+    csize bounds[SORT_MAX_THREADS + 1] = {0};
+    for (u32 i = 0; i <= pieces; i++) {
+        bounds[i] = (csize)(((u64)count * i) / pieces);
+    }
+
+    sort_task tasks[SORT_MAX_THREADS] = {0};
+    for (u32 i = 0; i < pieces; i++) {
+        tasks[i] = (sort_task) {
+            .dst = (u8*)l->data,
+            .element_size = l->element_size,
+            .cmp = cmp,
+            .begin = bounds[i],
+            .end = bounds[i + 1],
+        };
+    }
+    run_parallel(sort_piece, tasks, sizeof(*tasks), pieces);
+
+    // Merge neighboring runs, doubling the run length each round
+    u8* src = (u8*)l->data;
+    u8* dst = scratch;
+    for (u32 width = 1; width < pieces; width *= 2) {
+        u32 task_count = 0;
+        for (u32 i = 0; i < pieces; i += width * 2) {
+            // A run without a partner just gets copied over (as a merge with
+            // an empty right half).
+            tasks[task_count++] = (sort_task) {
+                .src = src,
+                .dst = dst,
+                .element_size = l->element_size,
+                .cmp = cmp,
+                .begin = bounds[i],
+                .mid = bounds[MIN(i + width, pieces)],
+                .end = bounds[MIN(i + (width * 2), pieces)],
+            };
+        }
+        run_parallel(merge_pieces, tasks, sizeof(*tasks), task_count);
+
+        u8* temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != (u8*)l->data) {
+        memcpy((void*)l->data, src, (size_t)count * l->element_size);
+    }
+    allocator_free(l->alloc, scratch);
+}
+
+// ---- Radix sort ----
+// Each pass sorts by one byte of the key. Every thread counts the bytes in its
+// piece of the list, then those counts are turned into the spot each thread
+// should start writing each bucket, and the threads scatter their pieces.
+
+typedef struct {
+    const u8* src;
+    u8* dst;
+    csize element_size;
+    csize key_offset;
+    csize key_size;
+    /// Which byte of the key this pass sorts by
+    u32 key_byte;
+    csize begin;
+    csize end;
+    /// Histogram for this piece, then its write positions for each bucket
+    csize buckets[RADIX_BUCKETS];
+}radix_task;
+
+static inline u8 radix_digit(const radix_task* task, const u8* element) {
+    const u8* key = element + task->key_offset;
+    u64 val = 0;
+    // Loading through the real integer type keeps this endian-independent
+    switch (task->key_size) {
+    case 1: val = *key; break;
+    case 2: { u16 k = 0; memcpy(&k, key, sizeof(k)); val = k; break; }
+    case 4: { u32 k = 0; memcpy(&k, key, sizeof(k)); val = k; break; }
+    case 8: { u64 k = 0; memcpy(&k, key, sizeof(k)); val = k; break; }
+    }
+    return (u8)(val >> (task->key_byte * 8));
+}
+
+static void radix_count(void* arg) {
+    radix_task* task = arg;
+    memset(task->buckets, 0x00, sizeof(task->buckets));
+    for (csize i = task->begin; i < task->end; i++) {
+        task->buckets[radix_digit(task, task->src + (i * task->element_size))]++;
+    }
+}
+
+static void radix_scatter(void* arg) {
+    radix_task* task = arg;
+    const csize size = task->element_size;
+    for (csize i = task->begin; i < task->end; i++) {
+        const u8* element = task->src + (i * size);
+        const u8 digit = radix_digit(task, element);
+        copy_element(task->dst + (task->buckets[digit]++ * size), element, size);
+    }
+}
+
+bool list_radix_sort(list* l, csize key_offset, csize key_size) {
+    if (key_size != 1 && key_size != 2 && key_size != 4 && key_size != 8) {
+        LOG_MSG(error, "Unsupported key size %d\n", (int)key_size);
+        return false;
+    }
+    if (key_offset + key_size > l->element_size) {
+        LOG_MSG(error, "Key doesn't fit inside the element\n");
+        return false;
+    }
+    const csize count = l->end_idx;
+    if (count < 2) {
+        return true;
+    }
+
+    u8* scratch = allocator_alloc(l->alloc, (size_t)count * l->element_size);
+    if (scratch == NULL) {
+        LOG_MSG(error, "Couldn't allocate sort buffer [0x%llX bytes]\n", (unsigned long long)count * l->element_size);
+        return false;
+    }
+
+    const u32 pieces = sort_thread_count(count);
+    radix_task* tasks = allocator_calloc(l->alloc, (size_t)pieces * sizeof(*tasks));
+    if (tasks == NULL) {
+        allocator_free(l->alloc, scratch);
+        return false;
+    }
+
+    u8* src = (u8*)l->data;
+    u8* dst = scratch;
+    for (u32 key_byte = 0; key_byte < key_size; key_byte++) {
+        for (u32 i = 0; i < pieces; i++) {
+            tasks[i] = (radix_task) {
+                .src = src,
+                .dst = dst,
+                .element_size = l->element_size,
+                .key_offset = key_offset,
+                .key_size = key_size,
+                .key_byte = key_byte,
+                .begin = (csize)(((u64)count * i) / pieces),
+                .end = (csize)(((u64)count * (i + 1)) / pieces),
+            };
+        }
+        run_parallel(radix_count, tasks, sizeof(*tasks), pieces);
+
+        // Turn the counts into write positions. Within each bucket, earlier
+        // pieces go first, which is what keeps the sort stable.
+        csize pos = 0;
+        bool all_same = false;
+        for (u32 digit = 0; digit < RADIX_BUCKETS; digit++) {
+            const csize bucket_start = pos;
+            for (u32 i = 0; i < pieces; i++) {
+                const csize bucket_count = tasks[i].buckets[digit];
+                tasks[i].buckets[digit] = pos;
+                pos += bucket_count;
+            }
+            all_same |= (pos - bucket_start == count);
+        }
+        if (all_same) {
+            // Every key has the same byte here, so this pass wouldn't change
+            // anything.
+            continue;
+        }
+
+        run_parallel(radix_scatter, tasks, sizeof(*tasks), pieces);
+        u8* temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != (u8*)l->data) {
+        memcpy((void*)l->data, src, (size_t)count * l->element_size);
+    }
+    allocator_free(l->alloc, tasks);
+    allocator_free(l->alloc, scratch);
+    return true;
+}
+
+// ---- Binary search ----
+
+csize list_lower_bound(list l, const void* key, list_compare cmp) {
+    csize low = 0;
+    csize high = l.end_idx;
+    while (low < high) {
+        const csize mid = low + ((high - low) / 2);
+        if (cmp(key, list_get_element(l, mid)) > 0) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+s64 list_bsearch(list l, const void* key, list_compare cmp) {
+    const csize idx = list_lower_bound(l, key, cmp);
+    if (idx < l.end_idx && cmp(key, list_get_element(l, idx)) == 0) {
+        return idx;
+    }
+    return -1;
+}
@@ -0,0 +1,65 @@
+#ifndef LIST_SORT_H
+#define LIST_SORT_H
+/// @file list_sort.h
+/// @brief Sorting & binary search for the dynamic list
+///
+/// Big lists are sorted on several threads at once. Once a list is sorted,
+/// lookups can use binary search instead of the linear @ref list_find().
+/// @sa list.h
+
+#include <stdbool.h>
+
+#include "int.h"
+#include "list.h"
+
+/// @brief Compare two elements, qsort() style.
+/// @return Negative if @p a goes before @p b, positive if it goes after, or 0
+/// if they're equal.
+typedef int (*list_compare)(const void* a, const void* b);
+
+enum {
+    /// Lists with at least this many elements are sorted on multiple threads
+    LIST_SORT_PARALLEL_MIN = 1 << 18,
+};
+
+/// @brief Sort a list with a comparison function.
+///
+/// Large lists are split into pieces that are sorted in parallel, then merged
+/// back together.
+/// @param l List to sort
+/// @param cmp Comparison function
+/// @note This allocates a temporary buffer the size of the list for big lists.
+void list_sort(list* l, list_compare cmp);
+
+/// @brief Sort a list by an unsigned integer key inside each element.
+///
+/// This is an LSD radix sort, which is much faster than @ref list_sort() for
+/// integer keys, and is stable (equal keys keep their original order). Passes
+/// where every key has the same byte are skipped, so small values in wide
+/// keys are cheap. Large lists are sorted in parallel.
+///
+/// @param l List to sort
+/// @param key_offset Offset of the key from the start of each element. For a
+/// list of plain integers, this is 0.
+/// @param key_size Size of the key in bytes: 1, 2, 4 or 8.
+/// @return Whether the list was sorted (fails on a bad key or alloc failure)
+/// @note This allocates a temporary buffer the size of the list.
+bool list_radix_sort(list* l, csize key_offset, csize key_size);
+
+/// @brief Search a sorted list for a value.
+/// @param l List to search. Must be sorted in the same order @p cmp defines.
+/// @param key Data to search for, passed as the first argument of @p cmp
+/// @param cmp Comparison function
+/// @return Index of a matching element, or -1 on failure.
+s64 list_bsearch(list l, const void* key, list_compare cmp);
+
+/// @brief Find the first element that doesn't go before @p key.
+/// @param l List to search. Must be sorted in the same order @p cmp defines.
+/// @param key Data to search for, passed as the first argument of @p cmp
+/// @param cmp Comparison function
+/// @return Index of the first element that is equal to or after @p key, or
+/// @ref list.end_idx if there isn't one. This is where @p key would be
+/// inserted to keep the list sorted.
+csize list_lower_bound(list l, const void* key, list_compare cmp);
+
+#endif // #ifndef LIST_SORT_H
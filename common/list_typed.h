@@ -0,0 +1,121 @@
+#ifndef LIST_TYPED_H
+#define LIST_TYPED_H
+/// @file list_typed.h
+/// @brief Type-specialized wrappers around the dynamic list
+///
+/// @ref LIST_DEFINE() generates a list type for one element type, with inline
+/// functions where the element size is a compile-time constant. That lets the
+/// compiler use plain loads & stores instead of memcpy() calls, and optimize
+/// loops over the elements.
+///
+/// The generated type is a union with a normal @ref list, so it can be passed
+/// to any list function through its @c base member. This makes it easy to
+/// migrate code one function at a time.
+/// @code
+/// typedef struct { float x, y, z; }vertex;
+/// LIST_DEFINE(vertex)
+///
+/// list_vertex verts = list_vertex_create(64);
+/// list_vertex_add(&verts, (vertex){1, 2, 3});
+/// const float x = verts.items[0].x;
+/// list_merge(&other.base, verts.base); // Works with normal list functions
+/// @endcode
+/// @sa list.h
+
+#include <string.h>
+#include <stdbool.h>
+
+#include "int.h"
+#include "list.h"
+
+/// @brief Generate a list type named list_T, and inline functions for it.
+///
+/// @param T Element type. This has to be a single identifier (so use a typedef
+/// for things like "unsigned int" or "struct foo").
+///
+/// Generated functions are named list_T_create(), list_T_destroy(),
+/// list_T_add(), list_T_get(), list_T_at(), list_T_find(), list_T_contains(),
+/// list_T_remove(), list_T_clear(), list_T_count() and list_T_empty(). They
+/// behave the same as the normal list functions with the same names.
+#define LIST_DEFINE(T)                                                         \
+    /** @brief List of T, layout-compatible with @ref list */                 \
+    typedef union {                                                            \
+        /** The underlying list, for use with the normal list functions */   \
+        list base;                                                             \
+        /** Typed view of the buffer (same as base.data) */                   \
+        T* items;                                                              \
+    }list_##T;                                                                 \
+                                                                               \
+    static inline list_##T list_##T##_create(csize init_count) {              \
+        return (list_##T){ .base = list_create(init_count * sizeof(T), sizeof(T)) }; \
+    }                                                                          \
+                                                                               \
+    static inline void list_##T##_destroy(list_##T* l) {                      \
+        list_destroy(&l->base);                                                \
+    }                                                                          \
+                                                                               \
+    static inline void list_##T##_add(list_##T* l, T val) {                   \
+        /* Same fullness check as list_add(), which handles growth */          \
+        if (l->base.end_idx + 1 < l->base.alloc_size / sizeof(T)) {            \
+            l->items[l->base.end_idx++] = val;                                 \
+            /* Compiles to nothing unless BOBTAIL_CONTAINER_STATS is set */    \
+            CONTAINER_STATS_COUNT(l->base.stats, l->base.end_idx);             \
+            return;                                                            \
+        }                                                                      \
+        list_add(&l->base, &val);                                              \
+    }                                                                          \
+                                                                               \
+    static inline T list_##T##_get(list_##T l, csize idx) {                   \
+        return l.items[idx];                                                   \
+    }                                                                          \
+                                                                               \
+    static inline T* list_##T##_at(list_##T l, csize idx) {                   \
+        return &l.items[idx];                                                  \
+    }                                                                          \
+                                                                               \
+    static inline s64 list_##T##_find(list_##T l, T val) {                    \
+        /* These sizes already have a vectorized search */                     \
+        if (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||              \
+            sizeof(T) == 8 || sizeof(T) == 16) {                               \
+            return list_find(l.base, &val);                                    \
+        }                                                                      \
+        for (csize i = 0; i < l.base.end_idx; i++) {                           \
+            if (memcmp(&l.items[i], &val, sizeof(T)) == 0) {                   \
+                return i;                                                      \
+            }                                                                  \
+        }                                                                      \
+        return -1;                                                             \
+    }                                                                          \
+                                                                               \
+    static inline bool list_##T##_contains(list_##T l, T val) {               \
+        return list_##T##_find(l, val) != -1;                                  \
+    }                                                                          \
+                                                                               \
+    static inline void list_##T##_remove(list_##T* l, csize idx) {            \
+        if (idx >= l->base.end_idx) {                                          \
+            return;                                                            \
+        }                                                                      \
+        const csize back = --l->base.end_idx;                                  \
+        l->items[idx] = l->items[back];                                        \
+        memset(&l->items[back], 0x00, sizeof(T));                              \
+    }                                                                          \
+                                                                               \
+    static inline void list_##T##_clear(list_##T* l) {                        \
+        list_clear(&l->base);                                                  \
+    }                                                                          \
+                                                                               \
+    static inline csize list_##T##_count(list_##T l) {                        \
+        return l.base.end_idx;                                                 \
+    }                                                                          \
+                                                                               \
+    static inline bool list_##T##_empty(list_##T l) {                         \
+        return l.base.end_idx == 0;                                            \
+    }
+
+// Lists of the basic integer types are common enough to always have around
+LIST_DEFINE(u8)
+LIST_DEFINE(u16)
+LIST_DEFINE(u32)
+LIST_DEFINE(u64)
+
+#endif // #ifndef LIST_TYPED_H
@@ -4,6 +4,7 @@
 
 #include "int.h"
 #include "file.h"
+#include "path.h"
 #include "logging.h"
 
 
@@ -85,9 +86,13 @@ void path_get_filename(const char* path, char* output) {
 }
 
 char* get_self_path(const char* argv_0) {
+    return get_self_path_alloc(argv_0, NULL);
+}
+
+char* get_self_path_alloc(const char* argv_0, const allocator* a) {
     // Allocate space for output string
     const u32 size = 4096;
-    char* out = calloc(1, size);
+    char* out = allocator_calloc(a, size);
     if (out == NULL) {
         LOG_MSG(error, "Failed to alloc %d bytes for executable path\n", size);
         return NULL;
@@ -156,7 +161,7 @@ char* get_self_path(const char* argv_0) {
     // find out our location
     if (argv_0 == NULL) {
         LOG_MSG(error, "argv[0] was a nullptr (and our only hope)!\n", argv_0);
-        free(out);
+        allocator_free(a, out);
         return NULL;
     }
 
@@ -167,8 +172,8 @@ char* get_self_path(const char* argv_0) {
         const u64 len = strlen(argv_0);
         if (len > size) {
             // Realloc if the argv[0] is absolutely massive for some reason
-            free(out);
-            out = calloc(1, len);
+            allocator_free(a, out);
+            out = allocator_calloc(a, (size_t)len + 1);
             if (out == NULL) {
                 LOG_MSG(error, "Couldn't allocate %d bytes to clone argv[0] string \"%s\"\n", argv_0);
                 return NULL;
@@ -5,6 +5,7 @@
 
 #include <stdbool.h>
 #include "int.h"
+#include "allocator.h"
 
 /// @brief Check that a path has a file extension.
 /// @param path Path to check
@@ -49,4 +50,10 @@ void path_get_filename(const char* path, char* output);
 /// string.
 char* get_self_path(const char* argv_0);
 
+/// @brief Same as @ref get_self_path(), but the output string comes from a
+/// specific allocator.
+/// @param a Allocator for the output string, or NULL for the default. Free
+/// the string with allocator_free() on the same allocator.
+char* get_self_path_alloc(const char* argv_0, const allocator* a);
+
 #endif // #ifndef PATH_H
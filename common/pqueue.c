@@ -0,0 +1,240 @@
+#include <string.h>
+#include <stdbool.h>
+
+#include "int.h"
+#include "logging.h"
+#include "list.h"
+#include "pqueue.h"
+
+enum {
+    /// Number of children per heap node
+    PQUEUE_ARITY = 4,
+};
+
+static inline pqueue_node* pqueue_nodes(pqueue q) {
+    return (pqueue_node*)q.heap.data;
+}
+
+static inline csize* pqueue_positions(pqueue q) {
+    return (csize*)q.positions.data;
+}
+
+/// Put a node at a heap index, and remember where it went
+static inline void pqueue_place(pqueue* q, csize idx, pqueue_node node) {
+    pqueue_nodes(*q)[idx] = node;
+    pqueue_positions(*q)[node.handle] = idx;
+}
+
+/// Move the node at @p idx up until its parent's key isn't bigger
+static void pqueue_sift_up(pqueue* q, csize idx) {
+    pqueue_node* nodes = pqueue_nodes(*q);
+    const pqueue_node node = nodes[idx];
+    while (idx > 0) {
+        const csize parent = (idx - 1) / PQUEUE_ARITY;
+        if (nodes[parent].key <= node.key) {
+            break;
+        }
+        pqueue_place(q, idx, nodes[parent]);
+        idx = parent;
+    }
+    pqueue_place(q, idx, node);
+}
+
+/// Move the node at @p idx down until none of its children have a smaller key
+static void pqueue_sift_down(pqueue* q, csize idx) {
+    pqueue_node* nodes = pqueue_nodes(*q);
+    const csize count = q->heap.end_idx;
+    const pqueue_node node = nodes[idx];
+    while (true) {
+        const u64 first = ((u64)idx * PQUEUE_ARITY) + 1;
+        if (first >= count) {
+            break;
+        }
+
+        // Find the smallest child. They're all next to each other, usually
+        // in the same cache line.
+        const csize last = (csize)MIN(first + PQUEUE_ARITY, count);
+        csize min_child = first;
+        for (csize c = first + 1; c < last; c++) {
+            if (nodes[c].key < nodes[min_child].key) {
+                min_child = c;
+            }
+        }
+        if (nodes[min_child].key >= node.key) {
+            break;
+        }
+        pqueue_place(q, idx, nodes[min_child]);
+        idx = min_child;
+    }
+    pqueue_place(q, idx, node);
+}
+
+pqueue pqueue_create(csize init_count, csize element_size) {
+    // Leave room for the extra slot lists always keep open
+    const u64 slots = (u64)init_count + 1;
+    pqueue q = {
+        .heap = list_create(slots * sizeof(pqueue_node), sizeof(pqueue_node)),
+        .positions = list_create(slots * sizeof(csize), sizeof(csize)),
+        .free_handles = list_create(16 * sizeof(csize), sizeof(csize)),
+        .element_size = element_size,
+    };
+    if (element_size != 0) {
+        q.values = list_create(slots * element_size, element_size);
+    }
+    return q;
+}
+
+void pqueue_destroy(pqueue* q) {
+    list_destroy(&q->heap);
+    list_destroy(&q->values);
+    list_destroy(&q->positions);
+    list_destroy(&q->free_handles);
+    *q = (pqueue){0};
+}
+
+/// Get a handle for a new element, reusing a popped one if we can
+static csize pqueue_new_handle(pqueue* q) {
+    if (q->free_handles.end_idx > 0) {
+        q->free_handles.end_idx--;
+        return *(csize*)list_get_element(q->free_handles, q->free_handles.end_idx);
+    }
+
+    const csize handle = q->positions.end_idx;
+    const csize invalid = PQUEUE_INVALID;
+    list_add(&q->positions, &invalid);
+    if (q->positions.end_idx == handle) {
+        return PQUEUE_INVALID; // Error was already printed
+    }
+    if (q->element_size != 0) {
+        // The data is copied in by the caller
+        if (!list_reserve(&q->values, handle + 1)) {
+            q->positions.end_idx--;
+            return PQUEUE_INVALID;
+        }
+        q->values.end_idx++;
+        CONTAINER_STATS_COUNT(q->values.stats, q->values.end_idx);
+    }
+    return handle;
+}
+
+csize pqueue_push(pqueue* q, u64 key, const void* data) {
+    const csize handle = pqueue_new_handle(q);
+    if (handle == PQUEUE_INVALID) {
+        return PQUEUE_INVALID;
+    }
+
+    const csize idx = q->heap.end_idx;
+    const pqueue_node node = { .key = key, .handle = handle };
+    list_add(&q->heap, &node);
+    if (q->heap.end_idx == idx) {
+        list_add(&q->free_handles, &handle);
+        return PQUEUE_INVALID;
+    }
+    if (q->element_size != 0) {
+        memcpy(list_get_element(q->values, handle), data, q->element_size);
+    }
+    pqueue_sift_up(q, idx);
+    return handle;
+}
+
+bool pqueue_pop(pqueue* q, u64* key, void* out) {
+    if (q->heap.end_idx == 0) {
+        return false;
+    }
+    const pqueue_node root = pqueue_nodes(*q)[0];
+    if (key != NULL) {
+        *key = root.key;
+    }
+    if (out != NULL && q->element_size != 0) {
+        memcpy(out, list_get_element(q->values, root.handle), q->element_size);
+    }
+    pqueue_positions(*q)[root.handle] = PQUEUE_INVALID;
+    list_add(&q->free_handles, &root.handle);
+
+    // Move the last node to the root & let it sink into place
+    q->heap.end_idx--;
+    if (q->heap.end_idx > 0) {
+        pqueue_nodes(*q)[0] = pqueue_nodes(*q)[q->heap.end_idx];
+        pqueue_sift_down(q, 0);
+    }
+    return true;
+}
+
+csize pqueue_peek(pqueue q, u64* key) {
+    if (q.heap.end_idx == 0) {
+        return PQUEUE_INVALID;
+    }
+    if (key != NULL) {
+        *key = pqueue_nodes(q)[0].key;
+    }
+    return pqueue_nodes(q)[0].handle;
+}
+
+bool pqueue_decrease_key(pqueue* q, csize handle, u64 new_key) {
+    if (!pqueue_contains(*q, handle)) {
+        return false;
+    }
+    const csize idx = pqueue_positions(*q)[handle];
+    pqueue_node* node = &pqueue_nodes(*q)[idx];
+    if (new_key > node->key) {
+        return false;
+    }
+    node->key = new_key;
+    pqueue_sift_up(q, idx);
+    return true;
+}
+
+bool pqueue_heapify(pqueue* q, const u64* keys, const void* data, csize count) {
+    pqueue_clear(q);
+    if (count == 0) {
+        return true;
+    }
+    if (!list_reserve(&q->heap, count) || !list_reserve(&q->positions, count)) {
+        return false;
+    }
+    if (q->element_size != 0) {
+        list_add_many(&q->values, data, count);
+        if (q->values.end_idx != count) {
+            return false;
+        }
+    }
+
+    for (csize i = 0; i < count; i++) {
+        const pqueue_node node = { .key = keys[i], .handle = i };
+        list_add(&q->heap, &node);
+        list_add(&q->positions, &i);
+    }
+
+    // Sift down every node that has children, from the bottom up. Most nodes
+    // are near the bottom & barely move, which is why this is O(n).
+    for (csize i = (count - 1) / PQUEUE_ARITY + 1; i > 0; i--) {
+        pqueue_sift_down(q, i - 1);
+    }
+    return true;
+}
+
+void* pqueue_get_element(pqueue q, csize handle) {
+    if (!pqueue_contains(q, handle) || q.element_size == 0) {
+        return NULL;
+    }
+    return list_get_element(q.values, handle);
+}
+
+bool pqueue_contains(pqueue q, csize handle) {
+    return handle < q.positions.end_idx && pqueue_positions(q)[handle] != PQUEUE_INVALID;
+}
+
+csize pqueue_count(pqueue q) {
+    return q.heap.end_idx;
+}
+
+bool pqueue_empty(pqueue q) {
+    return q.heap.end_idx == 0;
+}
+
+void pqueue_clear(pqueue* q) {
+    list_clear(&q->heap);
+    list_clear(&q->values);
+    list_clear(&q->positions);
+    list_clear(&q->free_handles);
+}
@@ -0,0 +1,115 @@
+#ifndef PQUEUE_H
+#define PQUEUE_H
+/// @file pqueue.h
+/// @brief Priority queue (min-heap) with u64 keys
+///
+/// Elements are ordered by a u64 key, smallest first. Push, pop and
+/// decrease-key are all O(log n), and building from an array is O(n).
+///
+/// The heap is 4-ary instead of binary: each node has 4 children, which all
+/// sit next to each other in memory. Heap entries are just the key & a
+/// handle (16 bytes), so a node's children share 1 cache line, and the tree
+/// is half as deep. Element data lives in a separate array indexed by handle,
+/// so it's never moved around by the heap.
+///
+/// Every element gets a handle when it's pushed, which stays the same until
+/// it's popped. Handles are used for @ref pqueue_decrease_key() and
+/// @ref pqueue_get_element(), and are recycled after the element is popped.
+///
+/// If your priorities aren't integers, map them to u64 in a way that keeps
+/// their order (e.g. the bits of a non-negative float).
+/// @note Elements with equal keys come out in no particular order.
+/// @sa queue.h
+
+#include <stdbool.h>
+
+#include "int.h"
+#include "list.h"
+
+/// Returned instead of a handle when something goes wrong
+#define PQUEUE_INVALID CSIZE_MAX
+
+/// A min-heap priority queue
+typedef struct {
+    /// Heap of @ref pqueue_node, the root is the smallest key
+    list heap;
+    /// Element data, indexed by handle
+    list values;
+    /// Heap index for each handle, or @ref PQUEUE_INVALID if it's not in the heap
+    list positions;
+    /// Handles that were popped & can be reused
+    list free_handles;
+    /// Size of each element. Can be 0 if the handles are all you need.
+    csize element_size;
+}pqueue;
+
+/// An entry in the heap
+typedef struct {
+    u64 key;
+    csize handle;
+}pqueue_node;
+
+/// @brief Create a priority queue.
+/// @param init_count Number of elements to allocate space for up front
+/// @param element_size Size of each element, or 0 to store only keys
+/// @note This allocates memory!
+/// @sa pqueue_destroy
+pqueue pqueue_create(csize init_count, csize element_size);
+
+/// Free all buffers & fill all fields with 0
+void pqueue_destroy(pqueue* q);
+
+/// @brief Add an element.
+/// @param q The queue to modify
+/// @param key Priority of the element, smaller comes first
+/// @param data The element, @ref pqueue.element_size bytes. Can be NULL if
+/// the element size is 0.
+/// @return Handle for the element, or @ref PQUEUE_INVALID on failure
+csize pqueue_push(pqueue* q, u64 key, const void* data);
+
+/// @brief Remove the element with the smallest key.
+/// @param q The queue to modify
+/// @param key Where to write the key of the element, or NULL
+/// @param out Where to copy the element, or NULL
+/// @return False if the queue was empty
+bool pqueue_pop(pqueue* q, u64* key, void* out);
+
+/// @brief Look at the element with the smallest key without removing it.
+/// @param q The queue
+/// @param key Where to write its key, or NULL
+/// @return Handle of the element, or @ref PQUEUE_INVALID if the queue is empty
+csize pqueue_peek(pqueue q, u64* key);
+
+/// @brief Lower the key of an element that's in the queue.
+/// @return False if the handle isn't in the queue, or @p new_key is bigger
+/// than its current key (nothing is changed in that case).
+bool pqueue_decrease_key(pqueue* q, csize handle, u64 new_key);
+
+/// @brief Replace everything in the queue with @p count elements, in O(n).
+///
+/// The elements get handles 0 to @p count - 1, in the same order as the
+/// input arrays.
+/// @param q The queue to modify
+/// @param keys Array of @p count keys
+/// @param data Array of @p count elements, or NULL if the element size is 0
+/// @param count Number of elements
+/// @return False on allocation failure (the queue is empty in that case)
+bool pqueue_heapify(pqueue* q, const u64* keys, const void* data, csize count);
+
+/// @brief Get the data for an element by its handle.
+/// @return Pointer to the element, or NULL if the handle isn't in the queue
+void* pqueue_get_element(pqueue q, csize handle);
+
+/// Check whether a handle belongs to an element that's in the queue
+bool pqueue_contains(pqueue q, csize handle);
+
+/// Number of elements in the queue
+csize pqueue_count(pqueue q);
+
+/// Check whether the queue is empty
+bool pqueue_empty(pqueue q);
+
+/// Remove all elements, without freeing any memory. All handles are invalidated.
+void pqueue_clear(pqueue* q);
+
+#endif // #ifndef PQUEUE_H
@@ -5,98 +5,201 @@
 #include "logging.h"
 #include "queue.h"
 
-s32 queue_maxidx(queue q) {
-    return (q.alloc_size / sizeof(*q.data)) - 1;
+enum {
+    /// Capacity of an empty queue after its first add
+    QUEUE_MIN_CAPACITY = 16,
+};
+
+/// Get a pointer to the slot at a (not yet masked) position
+static inline u8* queue_slot(queue q, csize pos) {
+    return (u8*)q.data + ((pos & (q.capacity - 1)) * q.element_size);
 }
 
-bool queue_fullback(queue q) {
-    return q.back_idx >= queue_maxidx(q) || queue_maxidx(q) < 0;
+csize queue_count(queue q) {
+    return q.tail - q.head;
 }
 
-bool queue_fullfront(queue q) {
-    return (q.front_idx == 0);
+bool queue_empty(queue q) {
+    return (q.head == q.tail);
 }
 
-bool queue_empty(queue q) {
-    return (q.front_idx == q.back_idx);
+queue queue_create(csize init_size, csize element_size) {
+    return queue_create_alloc(init_size, element_size, NULL);
 }
 
-bool queue_contains(queue* q, queue_element val) {
-    for (u32 i = q->front_idx; i < q->back_idx + 1; i++) {
-        if (q->data[i] == val) {
-            return true;
-        }
+queue queue_create_alloc(csize init_size, csize element_size, const allocator* a) {
+    a = (a != NULL) ? a : allocator_default();
+    if (element_size == 0) {
+        return (queue){ .alloc = a };
     }
 
-    return false;
-}
+    // Round up to a power of 2, so positions can be wrapped with a mask
+    u64 capacity = 1;
+    while (capacity * element_size < init_size) {
+        capacity *= 2;
+    }
+    if (capacity * element_size > CSIZE_MAX) {
+        LOG_MSG(error, "Can't fit a 0x%llX byte queue\n", (unsigned long long)init_size);
+        return (queue){ .element_size = element_size, .alloc = a };
+    }
 
-queue queue_create(u32 init_size) {
+    void* data = allocator_calloc(a, capacity * element_size);
     return (queue) {
-        .data = calloc(1, init_size),
-        .alloc_size = init_size,
-        .front_idx = 0,
-        .back_idx = 0
+        .data = (uintptr_t)data,
+        .capacity = (data != NULL) ? capacity : 0,
+        .element_size = element_size,
+        .alloc = a,
     };
 }
 
-void queue_add(queue* q, queue_element val) {
-    // If there's no room in the back
-    if (queue_fullback(*q)) {
-        if (!queue_fullfront(*q) && q->data != NULL) {
-            // We have open space at the front, so it can be transparently
-            // reclaimed to make room for the new value.
-            const u32 size = (q->back_idx - q->front_idx) * sizeof(*q->data);
-            memmove(q->data, &q->data[q->front_idx], size);
-            // Zero out the now unused memory
-            memset(((u8*)q->data) + size, 0x00, q->alloc_size - size);
-
-            // The old front idx is also the number of open spaces we just
-            // re-used. So the new back idx is just moved back by that amount.
-            q->back_idx -= q->front_idx;
-            q->front_idx = 0;
-        }
-        else {
-            // The buffer is completely full & needs a new allocation.
-            // Grow by 50%, rounded up to the next multiple of our data size.
-            const u32 newsize = ALIGN_UP((u32)(q->alloc_size * 1.5), sizeof(*q->data));
-            void* newbuf = calloc(1, newsize);
-            if (newbuf == NULL) {
-                LOG_MSG(error, "Couldn't expand queue 0x%X -> 0x%X [alloc failure]\n", q->alloc_size, newsize);
-                return;
-            }
-
-            // Copy data & update state
-            memcpy(newbuf, q->data, q->alloc_size);
-            free(q->data);
-            q->data = newbuf;
-            q->alloc_size = newsize;
-        }
-    }
-
-    // Put value in the next slot
-    q->data[q->back_idx++] = val;
+void queue_destroy(queue* q) {
+    void* data = (void*)q->data;
+    const allocator* a = q->alloc;
+    *q = (queue){0};
+    allocator_free(a, data);
+}
+
+/// @brief Grow the queue so it can hold at least @p min_capacity elements.
+///
+/// The capacity is at least doubled, and stays a power of 2. If the elements
+/// wrapped around the end of the old buffer, whichever part is smaller gets
+/// moved so the ring is still in order in the new buffer.
+static bool queue_grow(queue* q, u64 min_capacity) {
+    u64 new_capacity = (q->capacity == 0) ? QUEUE_MIN_CAPACITY : (u64)q->capacity * 2;
+    while (new_capacity < min_capacity && new_capacity <= CSIZE_MAX / 2) {
+        new_capacity *= 2;
+    }
+    const u64 old_size = (u64)q->capacity * q->element_size;
+    if (new_capacity < min_capacity || new_capacity > CSIZE_MAX / q->element_size) {
+        LOG_MSG(error, "Couldn't expand queue 0x%llX [too big]\n", (unsigned long long)old_size);
+        return false;
+    }
+    const u64 new_size = new_capacity * q->element_size;
+    if (q->alloc == NULL) {
+        q->alloc = allocator_default();
+    }
+    u8* newbuf = allocator_realloc(q->alloc, (void*)q->data, old_size, new_size);
+    if (newbuf == NULL) {
+        LOG_MSG(error, "Couldn't expand queue 0x%llX -> 0x%llX [alloc failure]\n", (unsigned long long)old_size, (unsigned long long)new_size);
+        return false;
+    }
+
+    const csize count = queue_count(*q);
+    const csize head_pos = (q->capacity != 0) ? (q->head & (q->capacity - 1)) : 0;
+    const csize first_run = MIN(count, q->capacity - head_pos);
+    const csize wrapped = count - first_run;
+    csize new_head = head_pos;
+    if (wrapped <= first_run) {
+        // Move the wrapped part from the start to right after the old end
+        memcpy(newbuf + old_size, newbuf, (size_t)wrapped * q->element_size);
+        CONTAINER_STATS_GROW(q->stats, old_size + ((u64)wrapped * q->element_size), new_size);
+    }
+    else {
+        // Move the front part to the very end, the wrapped part stays put
+        new_head = new_capacity - first_run;
+        memcpy(newbuf + ((u64)new_head * q->element_size), newbuf + ((u64)head_pos * q->element_size), (size_t)first_run * q->element_size);
+        CONTAINER_STATS_GROW(q->stats, old_size + ((u64)first_run * q->element_size), new_size);
+    }
+
+    q->data = (uintptr_t)newbuf;
+    q->capacity = new_capacity;
+    q->head = new_head;
+    q->tail = new_head + count;
+    return true;
+}
+
+void queue_copy_element(void* dst, const void* src, csize size) {
+    switch (size) {
+        case 1: memcpy(dst, src, 1); break;
+        case 2: memcpy(dst, src, 2); break;
+        case 4: memcpy(dst, src, 4); break;
+        case 8: memcpy(dst, src, 8); break;
+        case 16: memcpy(dst, src, 16); break;
+        default: memcpy(dst, src, size); break;
+    }
 }
 
-queue_element queue_get(queue* q) {
-    // We can't get a value if there's not enough buffer space for the read
-    if (q->alloc_size < sizeof(queue_element) || q->data == NULL) {
+void queue_add_grow(queue* q, const void* data) {
+    if (q->element_size == 0) {
+        LOG_MSG(error, "Queue has no element size!\n");
+        return;
+    }
+    if (queue_count(*q) == q->capacity && !queue_grow(q, (u64)q->capacity + 1)) {
+        return;
+    }
+
+    queue_copy_element(queue_slot(*q, q->tail), data, q->element_size);
+    q->tail++;
+    CONTAINER_STATS_COUNT(q->stats, queue_count(*q));
+}
+
+void queue_add_many(queue* q, const void* data, csize count) {
+    // Nothing to copy, & data is allowed to be NULL
+    if (count == 0) {
+        return;
+    }
+    if (q->element_size == 0) {
+        LOG_MSG(error, "Queue has no element size!\n");
+        return;
+    }
+    if (count > CSIZE_MAX - queue_count(*q)) {
+        LOG_MSG(error, "Can't fit 0x%llX more elements in a queue\n", (unsigned long long)count);
+        return;
+    }
+    const csize needed = queue_count(*q) + count;
+    if (needed > q->capacity && !queue_grow(q, needed)) {
+        return;
+    }
+
+    // The run can wrap around the end of the buffer, so it takes at most 2
+    // copies.
+    const csize start = q->tail & (q->capacity - 1);
+    const csize first = MIN(count, q->capacity - start);
+    const u8* src = data;
+    memcpy((u8*)q->data + ((u64)start * q->element_size), src, (size_t)first * q->element_size);
+    if (count > first) {
+        memcpy((u8*)q->data, src + ((u64)first * q->element_size), (size_t)(count - first) * q->element_size);
+    }
+    q->tail += count;
+    CONTAINER_STATS_COUNT(q->stats, queue_count(*q));
+}
+
+csize queue_get_many(queue* q, void* out, csize max_count) {
+    const csize count = MIN(max_count, queue_count(*q));
+    if (count == 0) {
         return 0;
     }
 
-    const queue_element val = q->data[q->front_idx++];
+    const csize start = q->head & (q->capacity - 1);
+    const csize first = MIN(count, q->capacity - start);
+    u8* dst = out;
+    memcpy(dst, (u8*)q->data + ((u64)start * q->element_size), (size_t)first * q->element_size);
+    if (count > first) {
+        memcpy(dst + ((u64)first * q->element_size), (u8*)q->data, (size_t)(count - first) * q->element_size);
+    }
+    q->head += count;
+    return count;
+}
 
-    // If this was the last item, reset so the entire buffer can be re-used.
-    if (q->front_idx == q->back_idx) {
-        q->front_idx = 0;
-        q->back_idx = 0;
+void* queue_peek(queue q) {
+    if (queue_empty(q)) {
+        return NULL;
     }
-    return val;
+    return queue_slot(q, q.head);
 }
 
 void queue_clear(queue* q) {
-    memset(q->data, 0x00, q->alloc_size);
-    q->front_idx = 0;
-    q->back_idx = 0;
+    q->head = 0;
+    q->tail = 0;
 }
 
+container_stats queue_stats(queue q) {
+#ifdef BOBTAIL_CONTAINER_STATS
+    container_stats stats = q.stats;
+    stats.suggested_init_size = (u64)stats.peak_count * q.element_size;
+    return stats;
+#else
+    (void)q;
+    return (container_stats){0};
+#endif
+}
@@ -3,10 +3,10 @@
 /// @file queue.h
 /// @brief An auto-expanding dynamic queue implementation
 ///
-/// Unlike the dynamic @ref list, this structure isn't really generic yet. Its
-/// type can be changed by editing the typedef of @ref queue_element at compile
-/// time, but there's no way to have multiple queues of multiple different
-/// types in one program.
+/// The queue is a ring buffer with a power of 2 capacity, so the head & tail
+/// wrap around with a mask instead of shuffling data back to the front. Adding
+/// & removing elements is always O(1), and the buffer is only reallocated when
+/// it's completely full.
 ///
 /// @warning Don't keep pointers / indices to elements of the queue for any
 /// longer than necessary! They are liable to point to different data or
@@ -16,11 +16,8 @@
 
 #include <stdbool.h>
 #include "int.h"
-
-// TODO: Make this structure generic like the dynamic list.
-
-/// The underlying data type used for the dynamic queue
-typedef u64 queue_element;
+#include "allocator.h"
+#include "container_stats.h"
 
 /// @brief An automatically expanding dynamic queue
 ///
@@ -31,32 +28,135 @@ typedef u64 queue_element;
 /// @sa list
 typedef struct {
     /// @brief Backing buffer
-    queue_element* data;
-    /// Current buffer size
-    u32 alloc_size;
-
-    /// Index of the front of the queue
-    u32 front_idx;
-    /// Index of the back of the queue
-    u32 back_idx;
+    ///
+    /// We use a uintptr_t so we can have a typeless pointer that can't
+    /// accidentally be dereferenced.
+    uintptr_t data;
+    /// Number of elements the buffer can hold. Always 0 or a power of 2.
+    csize capacity;
+    /// Size of each element
+    csize element_size;
+
+    /// @brief Position of the front of the queue.
+    ///
+    /// This keeps counting up & is masked with (capacity - 1) to get the slot,
+    /// so it's fine for it to wrap around.
+    csize head;
+    /// @brief Position one past the back of the queue, counting up like
+    /// @ref queue.head. The queue holds (tail - head) elements.
+    csize tail;
+
+    /// @brief Allocator for the backing buffer. NULL means the default
+    /// allocator at the time of the first allocation.
+    /// @sa allocator.h
+    const allocator* alloc;
+#ifdef BOBTAIL_CONTAINER_STATS
+    /// Growth counters, see container_stats.h
+    container_stats stats;
+#endif
 }queue;
 
 /// @brief Create a queue.
-/// @param init_size Initial allocation size in bytes
+/// @param init_size Initial allocation size in bytes. This is rounded up to
+/// a power of 2 number of elements.
+/// @param element_size Size of each element, see @ref list_create()
 /// @note This allocates memory!
-queue queue_create(u32 init_size);
+/// @sa queue_destroy
+queue queue_create(csize init_size, csize element_size);
+
+/// @brief Create a queue that gets its memory from a specific allocator.
+/// @param a Allocator for the backing buffer, or NULL for the default. This
+/// isn't copied, so it has to outlive the queue.
+/// @sa queue_create
+queue queue_create_alloc(csize init_size, csize element_size, const allocator* a);
+
+/// @brief Free the backing buffer & fill all fields with 0
+void queue_destroy(queue* q);
+
+/// @brief Copy one element of @p size bytes. Used by @ref queue_add() &
+/// @ref queue_get().
+///
+/// Common sizes get a fixed-size copy, which is cheaper than a call to
+/// memcpy(). This is kept out of line so the compiler never sees those
+/// copies next to a smaller buffer in the caller.
+void queue_copy_element(void* dst, const void* src, csize size);
+
+/// @brief Slow path of @ref queue_add(), for when the buffer is full (or the
+/// queue is invalid). Use @ref queue_add() instead.
+void queue_add_grow(queue* q, const void* data);
 
 /// @brief Add an element to the back of the queue.
+///
+/// This is inline, so adding to a queue with room left is just a mask, a copy
+/// & an increment. Growing is left to @ref queue_add_grow().
+/// @param q The queue to modify
+/// @param data The data to add. Must be at least @ref queue.element_size bytes
 /// @note If the backing buffer is full, this can allocate memory.
-void queue_add(queue* q, queue_element val);
+static inline void queue_add(queue* q, const void* data) {
+    // An invalid or zero-initialized queue has no capacity, so it always
+    // takes the slow path
+    if (q->tail - q->head < q->capacity) {
+        u8* slot = (u8*)q->data + ((u64)(q->tail & (q->capacity - 1)) * q->element_size);
+        queue_copy_element(slot, data, q->element_size);
+        q->tail++;
+        CONTAINER_STATS_COUNT(q->stats, q->tail - q->head);
+        return;
+    }
+    queue_add_grow(q, data);
+}
+
+/// @brief Remove the element at the front of the queue.
+/// @param q The queue to modify
+/// @param out Where to copy the element, or NULL to just drop it
+/// @return False if the queue was empty (and @p out wasn't touched)
+static inline bool queue_get(queue* q, void* out) {
+    if (q->head == q->tail) {
+        return false;
+    }
+    if (out != NULL) {
+        const u8* slot = (u8*)q->data + ((u64)(q->head & (q->capacity - 1)) * q->element_size);
+        queue_copy_element(out, slot, q->element_size);
+    }
+    q->head++;
+    return true;
+}
+
+/// @brief Add many elements to the back of the queue at once.
+///
+/// This makes 1 growth decision for the whole run, and copies it with at
+/// most 2 memcpy() calls (if it wraps around the end of the buffer).
+/// @param q The queue to modify
+/// @param data Array of @p count elements
+/// @param count Number of elements to add
+/// @note If the backing buffer is too small, this can allocate memory.
+void queue_add_many(queue* q, const void* data, csize count);
+
+/// @brief Remove up to @p max_count elements from the front of the queue at
+/// once, with at most 2 memcpy() calls.
+/// @param q The queue to modify
+/// @param out Array with room for @p max_count elements
+/// @param max_count Max number of elements to remove
+/// @return Number of elements copied into @p out
+csize queue_get_many(queue* q, void* out, csize max_count);
 
-/// Remove the element at the front of the queue, and return it.
-queue_element queue_get(queue* q);
+/// @brief Look at the element at the front of the queue without removing it.
+/// @return Pointer to the front element, or NULL if the queue is empty
+void* queue_peek(queue q);
 
-/// Reset internal state and fill backing buffer with 0. Does not free buffer.
+/// Number of elements in the queue
+csize queue_count(queue q);
+
+/// @brief Remove all elements. Does not free or zero the buffer.
+/// @note This is O(1), the old elements are just overwritten by later adds.
 void queue_clear(queue* q);
 
 /// Check whether the queue is empty
 bool queue_empty(queue q);
 
+/// @brief Get the growth counters for a queue.
+/// @return The counters, or all zeros if the library wasn't built with
+/// BOBTAIL_CONTAINER_STATS.
+/// @sa container_stats.h
+container_stats queue_stats(queue q);
+
 #endif // #ifndef QUEUE_H
@@ -0,0 +1,160 @@
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "logging.h"
+#include "queue.h"
+#include "thread.h"
+#include "queue_blocking.h"
+
+enum {
+    /// @brief Longest spin before sleeping, in CPU pauses.
+    ///
+    /// A futex sleep + wake costs a few microseconds, so spinning much longer
+    /// than that can't win back more than it wastes.
+    QUEUE_BLOCKING_MAX_SPIN = 2048,
+    /// Shortest spin we adapt down to (on multi-core machines)
+    QUEUE_BLOCKING_MIN_SPIN = 16,
+};
+
+bool queue_blocking_init(queue_blocking* q, csize init_size, csize element_size) {
+    const u32 max_spin = (thread_cpu_count() > 1) ? QUEUE_BLOCKING_MAX_SPIN : 0;
+    *q = (queue_blocking){
+        .q = queue_create(init_size, element_size),
+        .max_spin = max_spin,
+    };
+    if (q->q.data == 0) {
+        queue_destroy(&q->q);
+        return false;
+    }
+    if (!mutex_init(&q->lock)) {
+        LOG_MSG(error, "Failed to create mutex\n");
+        queue_destroy(&q->q);
+        return false;
+    }
+    atomic_init(&q->items_seq, 0);
+    atomic_init(&q->waiters, 0);
+    atomic_init(&q->spin_limit, max_spin / 4);
+    atomic_init(&q->closed, false);
+    return true;
+}
+
+void queue_blocking_destroy(queue_blocking* q) {
+    queue_destroy(&q->q);
+    mutex_destroy(&q->lock);
+    *q = (queue_blocking){0};
+}
+
+bool queue_blocking_push(queue_blocking* q, const void* data) {
+    mutex_lock(&q->lock);
+    // Checked under the lock, so nothing gets pushed after a consumer saw the
+    // queue closed & empty
+    const bool closed = atomic_load_explicit(&q->closed, memory_order_relaxed);
+    const csize old_tail = q->q.tail;
+    if (!closed) {
+        queue_add(&q->q, data);
+    }
+    const bool added = (q->q.tail != old_tail);
+    mutex_unlock(&q->lock);
+    if (!added) {
+        return false;
+    }
+
+    // Bumping the sequence before checking for waiters pairs with consumers
+    // registering as waiters before they sleep. Either the consumer sees the
+    // new sequence & doesn't sleep, or we see the consumer & wake it.
+    atomic_fetch_add(&q->items_seq, 1);
+    if (atomic_load(&q->waiters) > 0) {
+        thread_wake_one(&q->items_seq);
+    }
+    return true;
+}
+
+bool queue_blocking_try_pop(queue_blocking* q, void* out) {
+    mutex_lock(&q->lock);
+    const bool got = queue_get(&q->q, out);
+    mutex_unlock(&q->lock);
+    return got;
+}
+
+/// @brief Spin until the sequence number moves on from @p seq, then try to
+/// pop. Adjusts the spin length based on how it went.
+/// @return Whether we got an element
+static bool queue_blocking_spin(queue_blocking* q, u32 seq, void* out) {
+    const u32 limit = atomic_load_explicit(&q->spin_limit, memory_order_relaxed);
+    for (u32 i = 0; i < limit; i++) {
+        thread_pause();
+        if (atomic_load_explicit(&q->items_seq, memory_order_relaxed) == seq) {
+            continue;
+        }
+        if (queue_blocking_try_pop(q, out)) {
+            // Spinning paid off, so try spinning a bit longer next time
+            atomic_store_explicit(&q->spin_limit, MIN(limit * 2, q->max_spin), memory_order_relaxed);
+            return true;
+        }
+        // Someone else got it, keep going
+        seq = atomic_load_explicit(&q->items_seq, memory_order_relaxed);
+    }
+    if (q->max_spin > 0) {
+        atomic_store_explicit(&q->spin_limit, MAX(limit / 2, QUEUE_BLOCKING_MIN_SPIN), memory_order_relaxed);
+    }
+    return false;
+}
+
+queue_wait_result queue_blocking_pop(queue_blocking* q, void* out, u32 timeout_ms) {
+    u32 seq = atomic_load(&q->items_seq);
+    if (queue_blocking_try_pop(q, out)) {
+        return QUEUE_WAIT_OK;
+    }
+    if (atomic_load(&q->closed)) {
+        return QUEUE_WAIT_CLOSED;
+    }
+    if (timeout_ms == 0) {
+        return QUEUE_WAIT_TIMEOUT;
+    }
+    const u64 start = thread_time_ms();
+
+    if (queue_blocking_spin(q, seq, out)) {
+        return QUEUE_WAIT_OK;
+    }
+
+    while (true) {
+        // Grab the sequence before checking, so a push that lands after the
+        // check changes it & the futex won't let us sleep through it
+        seq = atomic_load(&q->items_seq);
+        if (queue_blocking_try_pop(q, out)) {
+            return QUEUE_WAIT_OK;
+        }
+        if (atomic_load(&q->closed)) {
+            return QUEUE_WAIT_CLOSED;
+        }
+
+        u32 remaining = THREAD_WAIT_FOREVER;
+        if (timeout_ms != THREAD_WAIT_FOREVER) {
+            const u64 elapsed = thread_time_ms() - start;
+            if (elapsed >= timeout_ms) {
+                return QUEUE_WAIT_TIMEOUT;
+            }
+            remaining = timeout_ms - (u32)elapsed;
+        }
+
+        atomic_fetch_add(&q->waiters, 1);
+        thread_wait(&q->items_seq, seq, remaining);
+        atomic_fetch_sub(&q->waiters, 1);
+    }
+}
+
+void queue_blocking_close(queue_blocking* q) {
+    mutex_lock(&q->lock);
+    atomic_store(&q->closed, true);
+    mutex_unlock(&q->lock);
+    atomic_fetch_add(&q->items_seq, 1);
+    thread_wake_all(&q->items_seq);
+}
+
+csize queue_blocking_count(queue_blocking* q) {
+    mutex_lock(&q->lock);
+    const csize count = queue_count(q->q);
+    mutex_unlock(&q->lock);
+    return count;
+}
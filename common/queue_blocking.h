@@ -0,0 +1,109 @@
+#ifndef QUEUE_BLOCKING_H
+#define QUEUE_BLOCKING_H
+/// @file queue_blocking.h
+/// @brief Thread-safe queue where consumers sleep until there's work
+///
+/// This wraps a normal @ref queue in a mutex, and adds a way for consumers to
+/// wait for elements without burning CPU. Producers bump a sequence number
+/// after every push, and consumers sleep on that number with
+/// @ref thread_wait() (a futex). Producers only make the wake syscall when
+/// someone is actually asleep, so pushing to a busy queue is just a lock &
+/// an atomic add.
+///
+/// Before going to sleep, a consumer spins for a short time in case an
+/// element shows up right away, since sleeping & waking up costs a few
+/// microseconds. The spin length adapts: it grows when spinning pays off, and
+/// shrinks when it doesn't. On single-core machines it never spins.
+///
+/// Closing the queue wakes all consumers. They can still pop whatever's left,
+/// then get @ref QUEUE_WAIT_CLOSED.
+/// @sa queue.h, queue_mpmc.h
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "queue.h"
+#include "thread.h"
+
+/// Result of waiting on a @ref queue_blocking
+typedef enum {
+    /// Got an element
+    QUEUE_WAIT_OK,
+    /// The timeout ran out before an element showed up
+    QUEUE_WAIT_TIMEOUT,
+    /// The queue is closed & empty, no more elements will show up
+    QUEUE_WAIT_CLOSED,
+}queue_wait_result;
+
+/// @brief An unbounded thread-safe queue with sleeping consumers
+///
+/// @warning Create & destroy aren't thread-safe, everything else is.
+typedef struct {
+    /// The elements, only touched with @ref queue_blocking.lock held
+    queue q;
+    mutex lock;
+    /// Most spins to try before sleeping, 0 on single-core machines
+    u32 max_spin;
+    u8 pad0[CACHE_LINE_SIZE];
+
+    /// @brief Bumped after every push & on close.
+    ///
+    /// Consumers sleep on this, so a change means it's worth checking again.
+    _Atomic(u32) items_seq;
+    /// Number of consumers asleep (or about to be)
+    _Atomic(u32) waiters;
+    /// Current adaptive spin length, up to @ref queue_blocking.max_spin
+    _Atomic(u32) spin_limit;
+    /// Set by @ref queue_blocking_close()
+    _Atomic(bool) closed;
+    u8 pad1[CACHE_LINE_SIZE];
+}queue_blocking;
+
+/// @brief Initialize a blocking queue in place.
+///
+/// The queue holds a mutex, so it can't be copied or moved afterwards.
+/// @param q The queue to initialize
+/// @param init_size Initial allocation size in bytes, see @ref queue_create()
+/// @param element_size Size of each element
+/// @return False if we ran out of memory or couldn't create the mutex
+/// @note This allocates memory!
+/// @sa queue_blocking_destroy
+bool queue_blocking_init(queue_blocking* q, csize init_size, csize element_size);
+
+/// @brief Free the queue & fill all fields with 0.
+/// @warning No other threads can be using the queue.
+void queue_blocking_destroy(queue_blocking* q);
+
+/// @brief Add an element to the back of the queue, waking a consumer if any
+/// are asleep.
+/// @return False if the queue was closed or we ran out of memory (the
+/// element isn't added either way)
+bool queue_blocking_push(queue_blocking* q, const void* data);
+
+/// @brief Remove the element at the front of the queue without waiting.
+/// @param q The queue to modify
+/// @param out Where to copy the element, or NULL to discard it
+/// @return False if the queue is empty
+bool queue_blocking_try_pop(queue_blocking* q, void* out);
+
+/// @brief Remove the element at the front of the queue, waiting for one if
+/// the queue is empty.
+/// @param q The queue to modify
+/// @param out Where to copy the element, or NULL to discard it
+/// @param timeout_ms Max time to wait, or @ref THREAD_WAIT_FOREVER. 0 just
+/// checks once.
+/// @return @ref QUEUE_WAIT_OK if @p out was filled in
+queue_wait_result queue_blocking_pop(queue_blocking* q, void* out, u32 timeout_ms);
+
+/// @brief Close the queue & wake every waiting consumer.
+///
+/// Pushes fail from now on. Consumers can still pop the elements that are
+/// left, after that they get @ref QUEUE_WAIT_CLOSED instead of waiting.
+void queue_blocking_close(queue_blocking* q);
+
+/// @brief Number of elements in the queue.
+/// @note With other threads active, this is only a snapshot.
+csize queue_blocking_count(queue_blocking* q);
+
+#endif // #ifndef QUEUE_BLOCKING_H
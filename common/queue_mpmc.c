@@ -0,0 +1,149 @@
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "logging.h"
+#include "queue_mpmc.h"
+
+/// Sequence number at the start of each slot
+typedef _Atomic(csize) cell_seq;
+
+static inline cell_seq* queue_mpmc_cell(const queue_mpmc* q, csize pos) {
+    return (cell_seq*)(q->cells + ((u64)(pos & (q->capacity - 1)) * q->cell_size));
+}
+
+/// The element stored after a slot's sequence number
+static inline u8* queue_mpmc_cell_data(cell_seq* cell) {
+    return (u8*)cell + sizeof(u64);
+}
+
+/// @brief Signed distance between 2 positions.
+///
+/// Positions wrap around, so this is done in unsigned math & then checked
+/// for the sign bit.
+static inline s64 queue_mpmc_diff(csize a, csize b) {
+    const csize diff = a - b;
+    return (diff > CSIZE_MAX / 2) ? -(s64)(csize)(b - a) : (s64)diff;
+}
+
+queue_mpmc queue_mpmc_create(csize capacity, csize element_size) {
+    // Round up to a power of 2, so positions can be wrapped with a mask. The
+    // algorithm needs at least 2 slots to tell "full" from "empty".
+    u64 rounded = 2;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    // The sequence number gets its own 8 bytes, so it's always aligned
+    const u64 cell_size = sizeof(u64) + ALIGN_UP((u64)element_size - 1, sizeof(u64));
+    if (element_size == 0 || rounded * cell_size > CSIZE_MAX || rounded > CSIZE_MAX / 2) {
+        LOG_MSG(error, "Can't fit 0x%llX elements of 0x%llX bytes\n", (unsigned long long)capacity, (unsigned long long)element_size);
+        return (queue_mpmc){0};
+    }
+
+    const allocator* a = allocator_default();
+    u8* cells = allocator_alloc(a, rounded * cell_size);
+    if (cells == NULL) {
+        return (queue_mpmc){0};
+    }
+    queue_mpmc q = {
+        .cells = cells,
+        .capacity = rounded,
+        .element_size = element_size,
+        .cell_size = cell_size,
+        .alloc = a,
+    };
+
+    // Every slot starts out waiting for the producer at its own position
+    for (csize i = 0; i < q.capacity; i++) {
+        atomic_init(queue_mpmc_cell(&q, i), i);
+    }
+    atomic_init(&q.enqueue_pos, 0);
+    atomic_init(&q.dequeue_pos, 0);
+    return q;
+}
+
+void queue_mpmc_destroy(queue_mpmc* q) {
+    u8* cells = q->cells;
+    const allocator* a = q->alloc;
+    *q = (queue_mpmc){0};
+    allocator_free(a, cells);
+}
+
+bool queue_mpmc_try_push(queue_mpmc* q, const void* data) {
+    csize pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    cell_seq* cell = NULL;
+    while (true) {
+        cell = queue_mpmc_cell(q, pos);
+        const csize seq = atomic_load_explicit(cell, memory_order_acquire);
+        const s64 diff = queue_mpmc_diff(seq, pos);
+        if (diff == 0) {
+            // The slot is free, try to claim this position. On failure, pos
+            // is updated to whatever another producer moved it to.
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // The slot still holds an element from the last lap, so we're full
+            return false;
+        }
+        else {
+            // Another producer already took this position
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(queue_mpmc_cell_data(cell), data, q->element_size);
+    // Hand the slot to the consumer at this position
+    atomic_store_explicit(cell, pos + 1, memory_order_release);
+    return true;
+}
+
+bool queue_mpmc_try_pop(queue_mpmc* q, void* out) {
+    csize pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    cell_seq* cell = NULL;
+    while (true) {
+        cell = queue_mpmc_cell(q, pos);
+        const csize seq = atomic_load_explicit(cell, memory_order_acquire);
+        const s64 diff = queue_mpmc_diff(seq, pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->dequeue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // Nothing has been written here yet, so we're empty
+            return false;
+        }
+        else {
+            pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(out, queue_mpmc_cell_data(cell), q->element_size);
+    // Hand the slot to the producer one lap later
+    atomic_store_explicit(cell, pos + q->capacity, memory_order_release);
+    return true;
+}
+
+void queue_mpmc_push(queue_mpmc* q, const void* data) {
+    u32 spins = 0;
+    while (!queue_mpmc_try_push(q, data)) {
+        thread_backoff(&spins);
+    }
+}
+
+void queue_mpmc_pop(queue_mpmc* q, void* out) {
+    u32 spins = 0;
+    while (!queue_mpmc_try_pop(q, out)) {
+        thread_backoff(&spins);
+    }
+}
+
+csize queue_mpmc_count(queue_mpmc* q) {
+    const csize head = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    const csize tail = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    const s64 count = queue_mpmc_diff(tail, head);
+    return (count < 0) ? 0 : MIN((csize)count, q->capacity);
+}
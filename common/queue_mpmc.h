@@ -0,0 +1,86 @@
+#ifndef QUEUE_MPMC_H
+#define QUEUE_MPMC_H
+/// @file queue_mpmc.h
+/// @brief Lock-free bounded queue for any number of producers & consumers
+///
+/// This is Dmitry Vyukov's bounded MPMC queue. Every slot in the ring has a
+/// sequence number that says whose turn it is: a producer at position p can
+/// fill the slot once its sequence is p, and a consumer at position p can
+/// empty it once its sequence is p + 1. Threads claim positions with a CAS
+/// on the shared enqueue/dequeue counters, then hand the slot over by
+/// bumping its sequence number. There's no global lock, and producers &
+/// consumers only touch each other's cache lines through the slots.
+///
+/// Elements can be any size, like the generic @ref queue.
+/// @sa queue_spsc.h
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "thread.h"
+#include "allocator.h"
+
+/// @brief A lock-free multi-producer/multi-consumer bounded queue
+///
+/// @warning Create & destroy aren't thread-safe.
+typedef struct {
+    /// @brief Slots, each one is a sequence number followed by the element.
+    /// @sa queue_mpmc.cell_size
+    u8* cells;
+    /// Number of elements the ring can hold. Always a power of 2.
+    csize capacity;
+    /// Size of each element
+    csize element_size;
+    /// Distance between slots in @ref queue_mpmc.cells
+    csize cell_size;
+    /// Allocator the slots came from
+    const allocator* alloc;
+    u8 pad0[CACHE_LINE_SIZE];
+
+    /// Next position for a producer to claim
+    _Atomic(csize) enqueue_pos;
+    u8 pad1[CACHE_LINE_SIZE];
+
+    /// Next position for a consumer to claim
+    _Atomic(csize) dequeue_pos;
+    u8 pad2[CACHE_LINE_SIZE];
+}queue_mpmc;
+
+/// @brief Create an MPMC queue.
+/// @param capacity Number of elements the queue can hold. This is rounded up
+/// to a power of 2 (and at least 2).
+/// @param element_size Size of each element
+/// @return A new queue, with a NULL @ref queue_mpmc.cells on failure.
+/// @sa queue_mpmc_destroy
+queue_mpmc queue_mpmc_create(csize capacity, csize element_size);
+
+/// @brief Free the slots & fill all fields with 0.
+/// @warning No other threads can be using the queue.
+void queue_mpmc_destroy(queue_mpmc* q);
+
+/// @brief Add an element to the back of the queue if there's room.
+/// @return False if the queue is full
+bool queue_mpmc_try_push(queue_mpmc* q, const void* data);
+
+/// @brief Remove the element at the front of the queue, if there is one.
+/// @param q The queue to modify
+/// @param out Where to copy the element
+/// @return False if the queue is empty
+bool queue_mpmc_try_pop(queue_mpmc* q, void* out);
+
+/// @brief Add an element, waiting for room if the queue is full.
+/// @note This spins, then yields (see @ref thread_backoff()). It doesn't put
+/// the thread to sleep, so don't use it for long waits.
+void queue_mpmc_push(queue_mpmc* q, const void* data);
+
+/// @brief Remove an element, waiting for one if the queue is empty.
+/// @note This spins, then yields (see @ref thread_backoff()). It doesn't put
+/// the thread to sleep, so don't use it for long waits.
+void queue_mpmc_pop(queue_mpmc* q, void* out);
+
+/// @brief Approximate number of elements in the queue.
+/// @note With other threads active, this is only a snapshot.
+csize queue_mpmc_count(queue_mpmc* q);
+
+#endif // #ifndef QUEUE_MPMC_H
@@ -0,0 +1,130 @@
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "logging.h"
+#include "queue_spsc.h"
+
+/// Get a pointer to the slot at a (not yet masked) position
+static inline u8* queue_spsc_slot(const queue_spsc* q, csize pos) {
+    return q->data + ((pos & (q->capacity - 1)) * q->element_size);
+}
+
+/// @brief Copy @p count elements into the ring starting at @p pos.
+///
+/// Takes at most 2 copies, if the run wraps around the end of the buffer.
+static void queue_spsc_write(queue_spsc* q, csize pos, const u8* src, csize count) {
+    const csize start = pos & (q->capacity - 1);
+    const csize first = MIN(count, q->capacity - start);
+    memcpy(q->data + ((u64)start * q->element_size), src, (size_t)first * q->element_size);
+    memcpy(q->data, src + ((u64)first * q->element_size), (size_t)(count - first) * q->element_size);
+}
+
+/// Same as @ref queue_spsc_write(), but copying out of the ring
+static void queue_spsc_read(const queue_spsc* q, csize pos, u8* dst, csize count) {
+    const csize start = pos & (q->capacity - 1);
+    const csize first = MIN(count, q->capacity - start);
+    memcpy(dst, q->data + ((u64)start * q->element_size), (size_t)first * q->element_size);
+    memcpy(dst + ((u64)first * q->element_size), q->data, (size_t)(count - first) * q->element_size);
+}
+
+queue_spsc queue_spsc_create(csize capacity, csize element_size) {
+    // Round up to a power of 2, so positions can be wrapped with a mask
+    u64 rounded = 1;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    if (element_size == 0 || rounded * element_size > CSIZE_MAX) {
+        LOG_MSG(error, "Can't fit 0x%llX elements of 0x%llX bytes\n", (unsigned long long)capacity, (unsigned long long)element_size);
+        return (queue_spsc){0};
+    }
+
+    const allocator* a = allocator_default();
+    u8* data = allocator_calloc(a, rounded * element_size);
+    if (data == NULL) {
+        return (queue_spsc){0};
+    }
+    return (queue_spsc) {
+        .data = data,
+        .capacity = rounded,
+        .element_size = element_size,
+        .alloc = a,
+    };
+}
+
+void queue_spsc_destroy(queue_spsc* q) {
+    u8* data = q->data;
+    const allocator* a = q->alloc;
+    *q = (queue_spsc){0};
+    allocator_free(a, data);
+}
+
+bool queue_spsc_push(queue_spsc* q, const void* data) {
+    // Only we write the tail, so a relaxed load sees our own latest value
+    const csize tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (tail - q->cached_head == q->capacity) {
+        // Looks full, check if the consumer made room since we last looked
+        q->cached_head = atomic_load_explicit(&q->head, memory_order_acquire);
+        if (tail - q->cached_head == q->capacity) {
+            return false;
+        }
+    }
+
+    memcpy(queue_spsc_slot(q, tail), data, q->element_size);
+    // Release, so the consumer sees the element before it sees the new tail
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+csize queue_spsc_push_many(queue_spsc* q, const void* data, csize count) {
+    const csize tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (q->capacity - (tail - q->cached_head) < count) {
+        q->cached_head = atomic_load_explicit(&q->head, memory_order_acquire);
+    }
+    count = MIN(count, q->capacity - (tail - q->cached_head));
+    if (count == 0) {
+        return 0;
+    }
+
+    queue_spsc_write(q, tail, data, count);
+    atomic_store_explicit(&q->tail, tail + count, memory_order_release);
+    return count;
+}
+
+bool queue_spsc_pop(queue_spsc* q, void* out) {
+    const csize head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if (head == q->cached_tail) {
+        // Looks empty, check if the producer added anything
+        q->cached_tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if (head == q->cached_tail) {
+            return false;
+        }
+    }
+
+    memcpy(out, queue_spsc_slot(q, head), q->element_size);
+    // Release, so the producer can't overwrite the slot before we've read it
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+csize queue_spsc_pop_many(queue_spsc* q, void* out, csize max_count) {
+    const csize head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if (q->cached_tail - head < max_count) {
+        q->cached_tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    }
+    const csize count = MIN(max_count, q->cached_tail - head);
+    if (count == 0) {
+        return 0;
+    }
+
+    queue_spsc_read(q, head, out, count);
+    atomic_store_explicit(&q->head, head + count, memory_order_release);
+    return count;
+}
+
+csize queue_spsc_count(queue_spsc* q) {
+    const csize head = atomic_load_explicit(&q->head, memory_order_acquire);
+    const csize tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return tail - head;
+}
@@ -0,0 +1,91 @@
+#ifndef QUEUE_SPSC_H
+#define QUEUE_SPSC_H
+/// @file queue_spsc.h
+/// @brief Lock-free bounded queue for 1 producer thread & 1 consumer thread
+///
+/// A fixed-size ring buffer where only the producer writes the tail and only
+/// the consumer writes the head. Each side publishes its index with a release
+/// store, and reads the other side's index with an acquire load, so no locks
+/// or read-modify-write atomics are needed.
+///
+/// Each side also keeps a cached copy of the other side's index, and only
+/// re-reads the real one when the cache says the ring is full (or empty).
+/// That way the cache line holding the other index is barely touched in the
+/// common case. The head & tail are padded onto separate cache lines.
+///
+/// @warning Exactly 1 thread can push and exactly 1 thread can pop. Use
+/// @ref queue_mpmc for anything else.
+/// @sa queue.h
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "thread.h"
+#include "allocator.h"
+
+/// @brief A lock-free single-producer/single-consumer bounded queue
+///
+/// @warning Create & destroy aren't thread-safe.
+typedef struct {
+    /// Backing buffer
+    u8* data;
+    /// Number of elements the ring can hold. Always a power of 2.
+    csize capacity;
+    /// Size of each element
+    csize element_size;
+    /// Allocator the buffer came from
+    const allocator* alloc;
+    u8 pad0[CACHE_LINE_SIZE];
+
+    /// Position of the front of the queue. Only written by the consumer.
+    _Atomic(csize) head;
+    /// Consumer's last view of @ref queue_spsc.tail
+    csize cached_tail;
+    u8 pad1[CACHE_LINE_SIZE];
+
+    /// Position one past the back of the queue. Only written by the producer.
+    _Atomic(csize) tail;
+    /// Producer's last view of @ref queue_spsc.head
+    csize cached_head;
+    u8 pad2[CACHE_LINE_SIZE];
+}queue_spsc;
+
+/// @brief Create an SPSC queue.
+/// @param capacity Number of elements the queue can hold. This is rounded up
+/// to a power of 2.
+/// @param element_size Size of each element
+/// @return A new queue, with a NULL @ref queue_spsc.data on failure.
+/// @sa queue_spsc_destroy
+queue_spsc queue_spsc_create(csize capacity, csize element_size);
+
+/// @brief Free the buffer & fill all fields with 0.
+/// @warning No other threads can be using the queue.
+void queue_spsc_destroy(queue_spsc* q);
+
+/// @brief Add an element to the back of the queue. Producer thread only.
+/// @return False if the queue is full
+bool queue_spsc_push(queue_spsc* q, const void* data);
+
+/// @brief Add up to @p count elements to the back of the queue. Producer
+/// thread only.
+/// @return Number of elements added, which is less than @p count if the queue
+/// filled up.
+csize queue_spsc_push_many(queue_spsc* q, const void* data, csize count);
+
+/// @brief Remove the element at the front of the queue. Consumer thread only.
+/// @param q The queue to modify
+/// @param out Where to copy the element
+/// @return False if the queue is empty
+bool queue_spsc_pop(queue_spsc* q, void* out);
+
+/// @brief Remove up to @p max_count elements from the front of the queue.
+/// Consumer thread only.
+/// @return Number of elements copied into @p out
+csize queue_spsc_pop_many(queue_spsc* q, void* out, csize max_count);
+
+/// @brief Number of elements in the queue.
+/// @note If the other thread is active, this is only a snapshot.
+csize queue_spsc_count(queue_spsc* q);
+
+#endif // #ifndef QUEUE_SPSC_H
@@ -0,0 +1,122 @@
+#include <string.h>
+#include <stdbool.h>
+
+#include "int.h"
+#include "logging.h"
+#include "vmem.h"
+#include "ring_queue.h"
+
+enum {
+    /// Number of views in the mapping. 2 is enough for any run up to the
+    /// ring size to be contiguous.
+    RING_QUEUE_VIEWS = 2,
+};
+
+/// Byte offset of the back of the queue (where the next element goes)
+static inline csize ring_queue_tail(ring_queue q) {
+    const u64 tail = (u64)q.head + ((u64)q.count * q.element_size);
+    return (tail >= q.ring_size) ? (csize)(tail - q.ring_size) : (csize)tail;
+}
+
+/// Move the head forward by some number of elements
+static inline void ring_queue_advance(ring_queue* q, csize count) {
+    const u64 head = (u64)q->head + ((u64)count * q->element_size);
+    q->head = (head >= q->ring_size) ? (csize)(head - q->ring_size) : (csize)head;
+    q->count -= count;
+}
+
+ring_queue ring_queue_create(csize min_size, csize element_size) {
+    if (element_size == 0) {
+        return (ring_queue){0};
+    }
+
+    // Round up to what the platform can map (a page on POSIX). Both views
+    // have to fit in the address range we can index with a csize.
+    const u64 granularity = vmem_repeat_granularity();
+    const u64 ring_size = MAX(((u64)min_size + granularity - 1) / granularity, 1) * granularity;
+    const u64 ring_pages = ring_size / VMEM_PAGE_SIZE;
+    if (ring_size * RING_QUEUE_VIEWS > CSIZE_MAX || ring_pages > UINT32_MAX || ring_size < element_size) {
+        LOG_MSG(error, "Can't make a 0x%llX byte ring for 0x%llX byte elements\n", (unsigned long long)min_size, (unsigned long long)element_size);
+        return (ring_queue){0};
+    }
+
+    u8* data = vmem_create_repeat_mapping_pages((u32)ring_pages, RING_QUEUE_VIEWS);
+    if (data == NULL) {
+        LOG_MSG(error, "Couldn't create a 0x%llX byte repeat mapping\n", (unsigned long long)ring_size);
+        return (ring_queue){0};
+    }
+
+    return (ring_queue) {
+        .data = data,
+        .ring_size = ring_size,
+        .element_size = element_size,
+        .capacity = ring_size / element_size,
+    };
+}
+
+void ring_queue_destroy(ring_queue* q) {
+    u8* data = q->data;
+    const u32 ring_pages = q->ring_size / VMEM_PAGE_SIZE;
+    *q = (ring_queue){0};
+    if (data != NULL) {
+        vmem_destroy_repeat_mapping_pages(data, ring_pages, RING_QUEUE_VIEWS);
+    }
+}
+
+bool ring_queue_add(ring_queue* q, const void* data) {
+    return ring_queue_add_many(q, data, 1);
+}
+
+bool ring_queue_add_many(ring_queue* q, const void* data, csize count) {
+    if (count > q->capacity - q->count) {
+        return false;
+    }
+    // Runs past the end of the ring land in the second view, so this never
+    // has to be split up.
+    memcpy(q->data + ring_queue_tail(*q), data, (size_t)count * q->element_size);
+    q->count += count;
+    return true;
+}
+
+bool ring_queue_get(ring_queue* q, void* out) {
+    if (q->count == 0) {
+        return false;
+    }
+    if (out != NULL) {
+        memcpy(out, q->data + q->head, q->element_size);
+    }
+    ring_queue_advance(q, 1);
+    return true;
+}
+
+csize ring_queue_get_many(ring_queue* q, void* out, csize max_count) {
+    const csize count = MIN(max_count, q->count);
+    memcpy(out, q->data + q->head, (size_t)count * q->element_size);
+    ring_queue_advance(q, count);
+    return count;
+}
+
+void* ring_queue_peek_span(ring_queue q, csize* count) {
+    *count = q.count;
+    if (q.count == 0) {
+        return NULL;
+    }
+    return q.data + q.head;
+}
+
+void ring_queue_consume(ring_queue* q, csize count) {
+    ring_queue_advance(q, MIN(count, q->count));
+}
+
+csize ring_queue_count(ring_queue q) {
+    return q.count;
+}
+
+bool ring_queue_empty(ring_queue q) {
+    return q.count == 0;
+}
+
+void ring_queue_clear(ring_queue* q) {
+    q->head = 0;
+    q->count = 0;
+}
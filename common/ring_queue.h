@@ -0,0 +1,96 @@
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+/// @file ring_queue.h
+/// @brief Fixed-size queue backed by a "magic ring" mapping
+///
+/// The buffer is a repeat mapping (see @ref vmem_create_repeat_mapping()),
+/// where the same physical memory is mapped twice back to back. Anything that
+/// runs off the end of the ring just continues into the second view, which is
+/// the start of the ring again. So any run of elements is contiguous in
+/// virtual memory, even when it wraps around.
+///
+/// That lets @ref ring_queue_peek_span() hand out a plain pointer & count for
+/// a whole batch of elements, and adding/getting many elements is always a
+/// single memcpy(), never a split copy.
+///
+/// Unlike @ref queue, this never grows. Adding to a full ring fails.
+/// @note Not available on Nintendo Switch, which can't make repeat mappings.
+/// @sa queue.h
+/// @sa vmem.h
+
+#include <stdbool.h>
+
+#include "int.h"
+
+/// @brief A fixed-size queue where every run of elements is contiguous
+/// @sa queue
+typedef struct {
+    /// Start of the repeat mapping (2 views of the ring)
+    u8* data;
+    /// Size of the ring in bytes (one view)
+    csize ring_size;
+    /// Size of each element
+    csize element_size;
+    /// Maximum number of elements
+    csize capacity;
+    /// Byte offset of the front of the queue, always less than the ring size
+    csize head;
+    /// Number of elements in the queue
+    csize count;
+}ring_queue;
+
+/// @brief Create a ring queue.
+/// @param min_size Minimum size of the ring in bytes. This is rounded up to
+/// a multiple of @ref vmem_repeat_granularity() (a page on POSIX, 64KiB on
+/// Windows).
+/// @param element_size Size of each element, see @ref list_create()
+/// @return A new empty ring queue, with a NULL @ref ring_queue.data on
+/// failure.
+/// @sa ring_queue_destroy
+ring_queue ring_queue_create(csize min_size, csize element_size);
+
+/// @brief Unmap the ring & fill all fields with 0
+void ring_queue_destroy(ring_queue* q);
+
+/// @brief Add an element to the back of the queue.
+/// @return False if the ring is full
+bool ring_queue_add(ring_queue* q, const void* data);
+
+/// @brief Add @p count elements to the back of the queue in one copy.
+/// @return False if they don't all fit (nothing is added in that case)
+bool ring_queue_add_many(ring_queue* q, const void* data, csize count);
+
+/// @brief Remove the element at the front of the queue.
+/// @param q The queue to modify
+/// @param out Where to copy the element, or NULL to just drop it
+/// @return False if the queue was empty
+bool ring_queue_get(ring_queue* q, void* out);
+
+/// @brief Remove up to @p max_count elements from the front of the queue in
+/// one copy.
+/// @return Number of elements copied into @p out
+csize ring_queue_get_many(ring_queue* q, void* out, csize max_count);
+
+/// @brief Look at all the elements in the queue, without copying them.
+/// @param q The queue to look at
+/// @param count Where to write the number of elements, which are all
+/// contiguous starting at the returned pointer.
+/// @return Pointer to the front element. Valid until the elements are
+/// consumed & overwritten by later adds.
+/// @sa ring_queue_consume
+void* ring_queue_peek_span(ring_queue q, csize* count);
+
+/// @brief Drop @p count elements from the front of the queue, usually after
+/// processing them through @ref ring_queue_peek_span().
+void ring_queue_consume(ring_queue* q, csize count);
+
+/// Number of elements in the queue
+csize ring_queue_count(ring_queue q);
+
+/// Check whether the queue is empty
+bool ring_queue_empty(ring_queue q);
+
+/// Remove all elements
+void ring_queue_clear(ring_queue* q);
+
+#endif // #ifndef RING_QUEUE_H
@@ -0,0 +1,129 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "int.h"
+#include "logging.h"
+#include "list.h"
+#include "seglist.h"
+
+/// Number of elements in each chunk
+static inline csize seglist_chunk_elements(seglist l) {
+    return (csize)1 << l.chunk_shift;
+}
+
+/// Pointer to the start of a chunk
+static inline u8* seglist_chunk(seglist l, csize chunk_idx) {
+    return *(u8**)list_get_element(l.chunks, chunk_idx);
+}
+
+seglist seglist_create(csize chunk_elements, csize element_size) {
+    // Round up to a power of 2, so we can index with a shift & mask
+    u8 shift = 0;
+    while (((csize)1 << shift) < chunk_elements && shift < (sizeof(csize) * 8) - 1) {
+        shift++;
+    }
+
+    return (seglist) {
+        .chunks = list_create(16 * sizeof(u8*), sizeof(u8*)),
+        .element_size = element_size,
+        .chunk_shift = shift,
+    };
+}
+
+void seglist_destroy(seglist* l) {
+    for (csize i = 0; i < l->chunks.end_idx; i++) {
+        allocator_free(l->chunks.alloc, seglist_chunk(*l, i));
+    }
+    list_destroy(&l->chunks);
+    *l = (seglist){0};
+}
+
+void* seglist_get_element(seglist l, csize idx) {
+    const csize chunk_idx = idx >> l.chunk_shift;
+    const csize offset = idx & (seglist_chunk_elements(l) - 1);
+    return seglist_chunk(l, chunk_idx) + (offset * l.element_size);
+}
+
+void* seglist_add(seglist* l, const void* data) {
+    // Chunks are kept after clearing, so we might already have one to use
+    const csize chunk_idx = l->end_idx >> l->chunk_shift;
+    if (chunk_idx >= l->chunks.end_idx) {
+        // Chunks come from the same allocator as the chunk table
+        if (l->chunks.alloc == NULL) {
+            l->chunks.alloc = allocator_default();
+        }
+        u8* chunk = allocator_calloc(l->chunks.alloc, (size_t)seglist_chunk_elements(*l) * l->element_size);
+        if (chunk == NULL) {
+            LOG_MSG(error, "Couldn't allocate new chunk of 0x%llX elements\n", (unsigned long long)seglist_chunk_elements(*l));
+            return NULL;
+        }
+        const csize old_count = l->chunks.end_idx;
+        list_add(&l->chunks, &chunk);
+        if (l->chunks.end_idx == old_count) {
+            allocator_free(l->chunks.alloc, chunk); // Chunk table couldn't grow, error was already printed.
+            return NULL;
+        }
+    }
+
+    void* next_slot = seglist_get_element(*l, l->end_idx++);
+    memcpy(next_slot, data, l->element_size);
+    return next_slot;
+}
+
+void seglist_remove(seglist* l, csize idx) {
+    if (idx >= l->end_idx) {
+        // Caller wants to remove an element that isn't used...
+        return;
+    }
+
+    // Same as the normal list, the last element takes the removed one's place
+    void* back_element = seglist_get_element(*l, l->end_idx - 1);
+    void* target_element = seglist_get_element(*l, idx);
+    memcpy(target_element, back_element, l->element_size);
+
+    // Zero out the back element just in case
+    memset(back_element, 0x00, l->element_size);
+    l->end_idx--;
+}
+
+void seglist_remove_val(seglist* l, const void* data) {
+    const s64 idx = seglist_find(*l, data);
+    if (idx == -1) {
+        return;
+    }
+    seglist_remove(l, idx);
+}
+
+s64 seglist_find(seglist l, const void* data) {
+    const csize chunk_elements = seglist_chunk_elements(l);
+    for (csize chunk_start = 0; chunk_start < l.end_idx; chunk_start += chunk_elements) {
+        // Each chunk is a normal contiguous array, so we can wrap it in a
+        // list and get the vectorized search for free.
+        const csize count = MIN(chunk_elements, l.end_idx - chunk_start);
+        const list view = {
+            .data = (uintptr_t)seglist_chunk(l, chunk_start >> l.chunk_shift),
+            .alloc_size = chunk_elements * l.element_size,
+            .end_idx = count,
+            .element_size = l.element_size,
+        };
+        const s64 idx = list_find(view, data);
+        if (idx != -1) {
+            return chunk_start + idx;
+        }
+    }
+
+    return -1;
+}
+
+bool seglist_contains(seglist l, const void* data) {
+    return seglist_find(l, data) != -1;
+}
+
+void seglist_clear(seglist* l) {
+    l->end_idx = 0;
+}
+
+bool seglist_empty(seglist l) {
+    return (l.end_idx == 0);
+}
@@ -0,0 +1,90 @@
+#ifndef SEGLIST_H
+#define SEGLIST_H
+/// @file seglist.h
+/// @brief Segmented dynamic list with stable element addresses
+///
+/// A segmented list stores its elements in fixed-size chunks instead of one
+/// big buffer. When it fills up, it just allocates another chunk, so existing
+/// elements are never moved or copied. That means pointers to elements stay
+/// valid while the list grows, unlike the normal @ref list.
+///
+/// Chunks always hold a power of 2 elements, so indexing is just a shift and
+/// a mask.
+/// @warning Removing elements still moves the last element into the removed
+/// slot (just like @ref list_remove()), so pointers to the last element are
+/// invalidated by any removal.
+/// @sa list.h
+
+#include <stdbool.h>
+
+#include "int.h"
+#include "list.h"
+
+/// @brief A segmented dynamic list with stable element addresses
+/// @sa list
+typedef struct {
+    /// @brief Table of pointers to each chunk.
+    ///
+    /// Only this table is ever reallocated, never the chunks themselves.
+    list chunks;
+    /// @brief Index of the next open slot (not the last element!)
+    csize end_idx;
+    /// Size of each element
+    csize element_size;
+    /// log2 of the number of elements in each chunk
+    u8 chunk_shift;
+}seglist;
+
+/// @brief Create a segmented list.
+/// @param chunk_elements Number of elements in each chunk. This is rounded up
+/// to a power of 2.
+/// @param element_size Size of each element, see @ref list_create()
+/// @return A newly initialized segmented list. No chunks are allocated until
+/// the first element is added.
+/// @sa seglist_destroy
+seglist seglist_create(csize chunk_elements, csize element_size);
+
+/// @brief Free all chunks & fill all fields with 0
+void seglist_destroy(seglist* l);
+
+/// @brief Append an element to the list.
+/// @param l The list to modify
+/// @param data The data to append. Must be at least
+/// @ref seglist.element_size bytes
+/// @return Pointer to the new element, which stays valid until it's removed
+/// (or the last element is removed), or NULL on failure.
+/// @note This allocates memory if the last chunk is full.
+void* seglist_add(seglist* l, const void* data);
+
+/// @brief Retrieve an element from the list.
+/// @return Generic pointer to the element. See @ref list_get_element().
+void* seglist_get_element(seglist l, csize idx);
+
+/// @brief Remove an element from the list.
+///
+/// Just like @ref list_remove(), the last element is moved into the removed
+/// slot, so don't make any assumptions about element order.
+void seglist_remove(seglist* l, csize idx);
+
+/// @brief Find and remove the first occurance of a value from the list.
+/// @sa seglist_remove
+void seglist_remove_val(seglist* l, const void* data);
+
+/// @brief Search for a value and return its index
+/// @param l List to search
+/// @param data Data to search for. Must be at least
+/// @ref seglist.element_size.
+/// @return Index of the data, or -1 on failure.
+s64 seglist_find(seglist l, const void* data);
+
+/// @brief Whether the list contains a certain value.
+/// @sa seglist_find
+bool seglist_contains(seglist l, const void* data);
+
+/// Remove every element. Chunks are kept around to be re-used.
+void seglist_clear(seglist* l);
+
+/// @brief Whether the list is empty
+bool seglist_empty(seglist l);
+
+#endif // #ifndef SEGLIST_H
@@ -0,0 +1,182 @@
+#ifndef THREAD_H
+#define THREAD_H
+/// @file thread.h
+/// @brief Minimal cross-platform threading primitives
+///
+/// Just enough to start & join threads, protect data with a mutex, and put
+/// threads to sleep until something changes. The thread-safe containers use
+/// C11 atomics directly, this is mostly for spinning up workers, sleeping
+/// instead of spinning, and for building simple lock-based baselines.
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "platform.h"
+
+#if defined(PLATFORM_POSIX)
+    #include <pthread.h>
+#endif
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+enum {
+    /// @brief Assumed size of a CPU cache line.
+    ///
+    /// Data written by different threads should be at least this far apart,
+    /// so the cores don't keep stealing the same line from each other (false
+    /// sharing). 64 is right for basically every x86 & ARM core.
+    CACHE_LINE_SIZE = 64,
+};
+
+/// Function run on a new thread
+typedef void (*thread_proc)(void* arg);
+
+/// Handle to a running thread (pthread_t or HANDLE)
+typedef struct {
+    uintptr_t handle;
+}thread;
+
+/// @brief A simple non-recursive mutex
+#if defined(PLATFORM_WINDOWS)
+typedef struct {
+    /// Storage for an SRWLOCK, which is just 1 pointer
+    void* lock;
+}mutex;
+#else
+typedef struct {
+    pthread_mutex_t lock;
+}mutex;
+#endif
+
+/// @brief A condition variable, for waiting until another thread signals
+/// while holding a @ref mutex.
+#if defined(PLATFORM_WINDOWS)
+typedef struct {
+    /// Storage for a CONDITION_VARIABLE, which is just 1 pointer
+    void* cond;
+}cond;
+#else
+typedef struct {
+    pthread_cond_t cond;
+}cond;
+#endif
+
+/// Pass as a timeout to wait forever
+#define THREAD_WAIT_FOREVER UINT32_MAX
+
+/// @brief Start a new thread
+/// @param t Where to put the new thread handle
+/// @param proc Function to run on the new thread
+/// @param arg Argument passed to @p proc
+/// @return Whether the thread was started
+/// @sa thread_join
+bool thread_create(thread* t, thread_proc proc, void* arg);
+
+/// Wait for a thread to finish, and free its resources
+void thread_join(thread t);
+
+/// Give up the rest of this thread's timeslice
+void thread_yield();
+
+/// Number of logical CPUs available (always at least 1)
+u32 thread_cpu_count();
+
+/// @brief Hint to the CPU that we're in a spin-wait loop.
+///
+/// This makes spinning a lot cheaper for the other hyperthread on the core,
+/// and saves power. It's a no-op on architectures without such a hint.
+static inline void thread_pause() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/// @brief Wait a little in a retry loop, backing off the longer it goes on.
+///
+/// The first few calls just pause the CPU. After that it yields, since on
+/// machines with fewer cores than threads spinning would just burn the
+/// timeslice the other thread needs to make progress.
+/// @param spins Counter for this wait, which should start at 0
+static inline void thread_backoff(u32* spins) {
+    if (*spins < 64) {
+        (*spins)++;
+        thread_pause();
+    }
+    else {
+        thread_yield();
+    }
+}
+
+/// @brief Milliseconds since some fixed point in the past.
+///
+/// This is a monotonic clock, so it's good for timeouts (but not for telling
+/// the date).
+u64 thread_time_ms();
+
+/// @brief Sleep until @p addr no longer holds @p expected, or until another
+/// thread wakes us.
+///
+/// This is a futex: on Linux it's the futex syscall, on Windows it's
+/// WaitOnAddress(). Elsewhere it falls back to a hashed table of condition
+/// variables. If the value is already different, it returns right away.
+/// @note Wakeups can be spurious, so always re-check the condition you're
+/// waiting for in a loop.
+/// @param addr The value to watch
+/// @param expected Only sleep while @p addr still holds this value
+/// @param timeout_ms Max time to sleep, or @ref THREAD_WAIT_FOREVER
+/// @return False if the timeout ran out
+/// @sa thread_wake_one
+bool thread_wait(_Atomic(u32)* addr, u32 expected, u32 timeout_ms);
+
+/// @brief Wake 1 thread sleeping in @ref thread_wait() on @p addr.
+///
+/// Change the value before calling this, otherwise the woken thread can just
+/// go back to sleep.
+void thread_wake_one(_Atomic(u32)* addr);
+
+/// Wake every thread sleeping in @ref thread_wait() on @p addr
+void thread_wake_all(_Atomic(u32)* addr);
+
+/// @brief Initialize a mutex in place. It starts unlocked.
+/// @note Mutexes can't be copied or moved once they're initialized.
+/// @return False if the system couldn't create the mutex
+bool mutex_init(mutex* m);
+
+/// Lock a mutex, waiting as long as needed
+void mutex_lock(mutex* m);
+
+/// Unlock a mutex locked by this thread
+void mutex_unlock(mutex* m);
+
+/// Free any resources used by a mutex. It must be unlocked.
+void mutex_destroy(mutex* m);
+
+/// @brief Initialize a condition variable in place.
+/// @note Condition variables can't be copied or moved once they're initialized.
+/// @return False if the system couldn't create the condition variable
+bool cond_init(cond* c);
+
+/// @brief Unlock @p m and sleep until signalled, then lock @p m again.
+/// @note Wakeups can be spurious, so always wait in a loop.
+/// @param c The condition variable
+/// @param m A mutex locked by this thread
+/// @param timeout_ms Max time to sleep, or @ref THREAD_WAIT_FOREVER
+/// @return False if the timeout ran out
+bool cond_wait(cond* c, mutex* m, u32 timeout_ms);
+
+/// Wake 1 thread waiting on the condition variable
+void cond_signal(cond* c);
+
+/// Wake every thread waiting on the condition variable
+void cond_broadcast(cond* c);
+
+/// Free any resources used by a condition variable. Nothing can be waiting on it.
+void cond_destroy(cond* c);
+
+#endif // #ifndef THREAD_H
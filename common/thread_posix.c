@@ -0,0 +1,207 @@
+// POSIX (Linux, BSD, Apple, generic Unix) implementation of thread.h interface
+
+#include "platform.h"
+
+#ifdef PLATFORM_POSIX
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#ifdef PLATFORM_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "int.h"
+#include "logging.h"
+#include "thread.h"
+
+// pthreads wants a function returning void*, so we need a trampoline to call
+// the user's function.
+typedef struct {
+    thread_proc proc;
+    void* arg;
+}thread_start;
+
+static void* thread_trampoline(void* arg) {
+    thread_start start = *(thread_start*)arg;
+    free(arg);
+    start.proc(start.arg);
+    return NULL;
+}
+
+bool thread_create(thread* t, thread_proc proc, void* arg) {
+    thread_start* start = malloc(sizeof(*start));
+    if (start == NULL) {
+        return false;
+    }
+    *start = (thread_start){ .proc = proc, .arg = arg };
+
+    pthread_t handle = {0};
+    if (pthread_create(&handle, NULL, thread_trampoline, start) != 0) {
+        LOG_MSG(error, "Failed to create thread\n");
+        free(start);
+        return false;
+    }
+    t->handle = (uintptr_t)handle;
+    return true;
+}
+
+void thread_join(thread t) {
+    pthread_join((pthread_t)t.handle, NULL);
+}
+
+void thread_yield() {
+    sched_yield();
+}
+
+u32 thread_cpu_count() {
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count < 1) ? 1 : (u32)count;
+}
+
+u64 thread_time_ms() {
+    struct timespec ts = {0};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((u64)ts.tv_sec * 1000) + ((u64)ts.tv_nsec / 1000000);
+}
+
+/// Absolute CLOCK_REALTIME deadline @p timeout_ms from now, for pthread_cond_timedwait()
+static struct timespec thread_deadline(u32 timeout_ms) {
+    struct timespec ts = {0};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+#ifdef PLATFORM_LINUX
+// The futex syscall does exactly what we want, the kernel checks the value &
+// puts us to sleep atomically.
+bool thread_wait(_Atomic(u32)* addr, u32 expected, u32 timeout_ms) {
+    struct timespec ts = {0};
+    struct timespec* timeout = NULL;
+    if (timeout_ms != THREAD_WAIT_FOREVER) {
+        // FUTEX_WAIT takes a relative timeout
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000;
+        timeout = &ts;
+    }
+    const long ret = syscall(SYS_futex, (u32*)addr, FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0);
+    return ret == 0 || errno != ETIMEDOUT;
+}
+
+void thread_wake_one(_Atomic(u32)* addr) {
+    syscall(SYS_futex, (u32*)addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+void thread_wake_all(_Atomic(u32)* addr) {
+    syscall(SYS_futex, (u32*)addr, FUTEX_WAKE_PRIVATE, INT32_MAX, NULL, NULL, 0);
+}
+#else
+// No portable futex, so we hash the address into a table of mutex + condvar
+// pairs. Waking always broadcasts, since other addresses can share a bucket.
+// Waiters re-check their value under the bucket lock, so no wakeup is lost.
+enum {
+    THREAD_WAIT_BUCKETS = 64,
+};
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+}thread_wait_bucket;
+
+static thread_wait_bucket thread_wait_table[THREAD_WAIT_BUCKETS];
+static pthread_once_t thread_wait_once = PTHREAD_ONCE_INIT;
+
+static void thread_wait_init() {
+    for (u32 i = 0; i < THREAD_WAIT_BUCKETS; i++) {
+        pthread_mutex_init(&thread_wait_table[i].lock, NULL);
+        pthread_cond_init(&thread_wait_table[i].cond, NULL);
+    }
+}
+
+static thread_wait_bucket* thread_wait_get_bucket(_Atomic(u32)* addr) {
+    pthread_once(&thread_wait_once, thread_wait_init);
+    const uintptr_t hash = ((uintptr_t)addr >> 2) * 0x9E3779B1;
+    return &thread_wait_table[(hash >> 8) % THREAD_WAIT_BUCKETS];
+}
+
+bool thread_wait(_Atomic(u32)* addr, u32 expected, u32 timeout_ms) {
+    thread_wait_bucket* bucket = thread_wait_get_bucket(addr);
+    const struct timespec deadline = thread_deadline(timeout_ms);
+    bool woken = true;
+    pthread_mutex_lock(&bucket->lock);
+    if (atomic_load(addr) == expected) {
+        if (timeout_ms == THREAD_WAIT_FOREVER) {
+            pthread_cond_wait(&bucket->cond, &bucket->lock);
+        }
+        else {
+            woken = pthread_cond_timedwait(&bucket->cond, &bucket->lock, &deadline) != ETIMEDOUT;
+        }
+    }
+    pthread_mutex_unlock(&bucket->lock);
+    return woken;
+}
+
+void thread_wake_one(_Atomic(u32)* addr) {
+    thread_wake_all(addr);
+}
+
+void thread_wake_all(_Atomic(u32)* addr) {
+    thread_wait_bucket* bucket = thread_wait_get_bucket(addr);
+    // Taking the lock means a waiter is either before its value check, or
+    // already asleep. Either way it sees the new value.
+    pthread_mutex_lock(&bucket->lock);
+    pthread_cond_broadcast(&bucket->cond);
+    pthread_mutex_unlock(&bucket->lock);
+}
+#endif
+
+bool mutex_init(mutex* m) {
+    return pthread_mutex_init(&m->lock, NULL) == 0;
+}
+
+void mutex_lock(mutex* m) {
+    pthread_mutex_lock(&m->lock);
+}
+
+void mutex_unlock(mutex* m) {
+    pthread_mutex_unlock(&m->lock);
+}
+
+void mutex_destroy(mutex* m) {
+    pthread_mutex_destroy(&m->lock);
+}
+
+bool cond_init(cond* c) {
+    return pthread_cond_init(&c->cond, NULL) == 0;
+}
+
+bool cond_wait(cond* c, mutex* m, u32 timeout_ms) {
+    if (timeout_ms == THREAD_WAIT_FOREVER) {
+        pthread_cond_wait(&c->cond, &m->lock);
+        return true;
+    }
+    const struct timespec deadline = thread_deadline(timeout_ms);
+    return pthread_cond_timedwait(&c->cond, &m->lock, &deadline) != ETIMEDOUT;
+}
+
+void cond_signal(cond* c) {
+    pthread_cond_signal(&c->cond);
+}
+
+void cond_broadcast(cond* c) {
+    pthread_cond_broadcast(&c->cond);
+}
+
+void cond_destroy(cond* c) {
+    pthread_cond_destroy(&c->cond);
+}
+#endif
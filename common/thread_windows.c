@@ -0,0 +1,125 @@
+// Windows implementation of thread.h interface
+
+#include "platform.h"
+
+#ifdef PLATFORM_WINDOWS
+#include <Windows.h>
+#include <stdlib.h>
+
+#include "int.h"
+#include "logging.h"
+#include "thread.h"
+
+// Windows wants a function with a DWORD return & calling convention, so we
+// need a trampoline to call the user's function.
+typedef struct {
+    thread_proc proc;
+    void* arg;
+}thread_start;
+
+static DWORD WINAPI thread_trampoline(LPVOID arg) {
+    thread_start start = *(thread_start*)arg;
+    free(arg);
+    start.proc(start.arg);
+    return 0;
+}
+
+bool thread_create(thread* t, thread_proc proc, void* arg) {
+    thread_start* start = malloc(sizeof(*start));
+    if (start == NULL) {
+        return false;
+    }
+    *start = (thread_start){ .proc = proc, .arg = arg };
+
+    HANDLE handle = CreateThread(NULL, 0, thread_trampoline, start, 0, NULL);
+    if (handle == NULL) {
+        LOG_MSG(error, "Failed to create thread\n");
+        free(start);
+        return false;
+    }
+    t->handle = (uintptr_t)handle;
+    return true;
+}
+
+void thread_join(thread t) {
+    WaitForSingleObject((HANDLE)t.handle, INFINITE);
+    CloseHandle((HANDLE)t.handle);
+}
+
+void thread_yield() {
+    SwitchToThread();
+}
+
+u32 thread_cpu_count() {
+    SYSTEM_INFO info = {0};
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors < 1) ? 1 : info.dwNumberOfProcessors;
+}
+
+u64 thread_time_ms() {
+    return GetTickCount64();
+}
+
+// WaitOnAddress() is the Windows version of a futex (Windows 8 and up, needs
+// Synchronization.lib).
+bool thread_wait(_Atomic(u32)* addr, u32 expected, u32 timeout_ms) {
+    const DWORD timeout = (timeout_ms == THREAD_WAIT_FOREVER) ? INFINITE : timeout_ms;
+    if (!WaitOnAddress((volatile VOID*)addr, &expected, sizeof(expected), timeout)) {
+        return GetLastError() != ERROR_TIMEOUT;
+    }
+    return true;
+}
+
+void thread_wake_one(_Atomic(u32)* addr) {
+    WakeByAddressSingle((PVOID)addr);
+}
+
+void thread_wake_all(_Atomic(u32)* addr) {
+    WakeByAddressAll((PVOID)addr);
+}
+
+// SRWLOCKs are a single pointer and need no cleanup, so they fit right in our
+// mutex struct.
+bool mutex_init(mutex* m) {
+    InitializeSRWLock((PSRWLOCK)&m->lock);
+    return true;
+}
+
+void mutex_lock(mutex* m) {
+    AcquireSRWLockExclusive((PSRWLOCK)&m->lock);
+}
+
+void mutex_unlock(mutex* m) {
+    ReleaseSRWLockExclusive((PSRWLOCK)&m->lock);
+}
+
+void mutex_destroy(mutex* m) {
+    *m = (mutex){0};
+}
+
+// Like SRWLOCKs, CONDITION_VARIABLEs are a single pointer with no cleanup
+bool cond_init(cond* c) {
+    InitializeConditionVariable((PCONDITION_VARIABLE)&c->cond);
+    return true;
+}
+
+bool cond_wait(cond* c, mutex* m, u32 timeout_ms) {
+    const DWORD timeout = (timeout_ms == THREAD_WAIT_FOREVER) ? INFINITE : timeout_ms;
+    if (!SleepConditionVariableSRW((PCONDITION_VARIABLE)&c->cond, (PSRWLOCK)&m->lock, timeout, 0)) {
+        return GetLastError() != ERROR_TIMEOUT;
+    }
+    return true;
+}
+
+void cond_signal(cond* c) {
+    WakeConditionVariable((PCONDITION_VARIABLE)&c->cond);
+}
+
+void cond_broadcast(cond* c) {
+    WakeAllConditionVariable((PCONDITION_VARIABLE)&c->cond);
+}
+
+void cond_destroy(cond* c) {
+    *c = (cond){0};
+}
+#endif
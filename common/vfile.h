@@ -35,7 +35,7 @@ bool vfile_writecheck(vfile* file, u32 writesize);
 /// For example:
 /// @code
 /// vfile f = ...;
-/// const u32 data = VFILE_READ(u32, f);
+/// const u32 data = VFILE_READ(u32, &f);
 /// @endcode
 ///
 /// @param T The data type to read
@@ -43,7 +43,7 @@ bool vfile_writecheck(vfile* file, u32 writesize);
 /// @return The requested data is returned as if this was a function of return
 /// type @p T.
 // TODO: Use MIN() here to avoid reading out of bounds
-#define VFILE_READ(T, file) (*((T)*)(&(file)->ptr[((file)->pos += sizeof(T)) - sizeof(T)]))
+#define VFILE_READ(T, file) (*(T*)(&(file)->ptr[((file)->pos += sizeof(T)) - sizeof(T)]))
 
 /// @brief Write data to a virtual file.
 ///
@@ -51,8 +51,8 @@ bool vfile_writecheck(vfile* file, u32 writesize);
 /// @code
 /// vfile f = ...;
 /// const u32 data = 10;
-/// VFILE_WRITE(u32, f, data); // Write a 32-bit variable
-/// VFILE_WRITE(u64, f, 20); // Write a literal as an 8-byte int
+/// VFILE_WRITE(u32, &f, data); // Write a 32-bit variable
+/// VFILE_WRITE(u64, &f, 20); // Write a literal as an 8-byte int
 /// @endcode
 ///
 /// @param T The data type to write to memory. Any type can be used, as long as
@@ -63,7 +63,7 @@ bool vfile_writecheck(vfile* file, u32 writesize);
 #define VFILE_WRITE(T, file, val)                         \
     do {                                                  \
         if (vfile_writecheck(file, sizeof(T))) {          \
-            *((T)*)(&(file)->ptr[(file)->pos]) = (val);   \
+            *(T*)(&(file)->ptr[(file)->pos]) = (val);     \
             const u32 _newpos = (file)->pos + sizeof(T);  \
             (file)->pos = MIN(_newpos, (file)->size - 1); \
         }                                                 \
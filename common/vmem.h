@@ -29,22 +29,58 @@ enum {
 /// circular buffers are useful to you, they also let you use a circular buffer
 /// on functions that only expect a linear buffer.
 ///
-/// @param ring_width The size of the backing buffer as a multiple of 64KiB. On
-/// POSIX it's possible to acheive 4KiB page-level granularity, but for
-/// consistency it matches the Windows 64KiB granularity.
+/// This is the same as @ref vmem_create_repeat_mapping_pages(), with the ring
+/// size given in units of 64KiB so it works the same everywhere.
+///
+/// @param ring_width The size of the backing buffer as a multiple of 64KiB.
 /// @param repeat_count How many "views" of the backing buffer to create.
 ///
-/// @return Pointer to the start of the mapping. The usable size is
-/// (@p ring_width * VMEM_ALLOC_GRANULARITY * @p repeat_count).
+/// @return Pointer to the start of the mapping, or NULL on failure. The
+/// usable size is (@p ring_width * VMEM_ALLOC_GRANULARITY * @p repeat_count).
 ///
 /// @note This function is not available on Nintendo Switch.
+/// @sa vmem_destroy_repeat_mapping
 void* vmem_create_repeat_mapping(u32 ring_width, u32 repeat_count);
 
-/// @brief Delete a repeat mapping
+/// @brief Delete a repeat mapping made with @ref vmem_create_repeat_mapping()
 ///
 /// @note This function is not available on Nintendo Switch.
 void vmem_destroy_repeat_mapping(void* base_addr, u32 ring_width, u32 repeat_count);
 
+/// @brief Smallest ring size (in bytes) that repeat mappings support.
+///
+/// Ring sizes have to be a multiple of this. It's @ref VMEM_PAGE_SIZE on
+/// POSIX, and @ref VMEM_ALLOC_GRANULARITY on Windows (where views can only
+/// start on 64KiB boundaries).
+/// @note This function is not available on Nintendo Switch.
+u32 vmem_repeat_granularity();
+
+/// @brief Create a repeat mapping with the ring size in pages.
+///
+/// Works like @ref vmem_create_repeat_mapping(), but the ring can be as
+/// small as a single page where the platform allows it, so lots of small
+/// rings don't each cost 64KiB.
+///
+/// This is safe to call from many threads (and processes) at once: the
+/// backing memory is an anonymous file (memfd on Linux) that no one else
+/// can open. If anything fails, everything mapped so far is cleaned up.
+///
+/// @param ring_pages Size of the backing buffer in units of
+/// @ref VMEM_PAGE_SIZE. The size in bytes has to be a multiple of
+/// @ref vmem_repeat_granularity().
+/// @param repeat_count How many "views" of the backing buffer to create.
+///
+/// @return Pointer to the start of the mapping, or NULL on failure. The
+/// usable size is (@p ring_pages * VMEM_PAGE_SIZE * @p repeat_count).
+/// @note This function is not available on Nintendo Switch.
+/// @sa vmem_destroy_repeat_mapping_pages
+void* vmem_create_repeat_mapping_pages(u32 ring_pages, u32 repeat_count);
+
+/// @brief Delete a repeat mapping made with @ref vmem_create_repeat_mapping_pages()
+///
+/// @note This function is not available on Nintendo Switch.
+void vmem_destroy_repeat_mapping_pages(void* base_addr, u32 ring_pages, u32 repeat_count);
+
 
 
 /// @brief Reserve a virtual memory region without committing any physical RAM.
@@ -62,6 +98,8 @@ void* vmem_reserve(u64 size);
 /// If successful, memory in the region becomes usable and space is reserved in
 /// the page file. Actual physical pages are only allocated as needed when
 /// parts of the committed region are accessed.
+/// @warning Only commit pages that haven't been committed yet. On some
+/// platforms, committing a page again throws away its contents.
 /// @return 0 on success, -1 on failure.
 int vmem_commit(void* addr, u64 size);
 
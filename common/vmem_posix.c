@@ -4,52 +4,120 @@
 
 #ifdef PLATFORM_POSIX
 #include <stdlib.h> // For NULL
+#include <stdint.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#ifdef PLATFORM_LINUX
+#include <sys/syscall.h>
+#include <linux/memfd.h>
+#endif
+
 #include "int.h"
+#include "logging.h"
 #include "vmem.h"
-#include <sys/mman.h>
-#include <fcntl.h>
-#include <stdio.h>
 
-void* vmem_create_repeat_mapping(u32 ring_width, u32 repeat_count) {
+/// @brief Make an anonymous in-memory file that only we can see.
+///
+/// On Linux this is a memfd, which has no name at all. Elsewhere (or on
+/// kernels too old for memfd), it's a POSIX shared memory object with a name
+/// unique to this call, which we delete right away. The old fixed name meant
+/// two threads making a ring at the same time would share (and resize) each
+/// other's file.
+/// @return File descriptor, or -1 on failure
+static int vmem_anonymous_file() {
+#if defined(PLATFORM_LINUX) && defined(SYS_memfd_create)
+    const int memfd = (int)syscall(SYS_memfd_create, "bobtail_repeat_mapping", MFD_CLOEXEC);
+    if (memfd != -1) {
+        return memfd;
+    }
+#endif
+
+    static _Atomic(u32) counter = 0;
+    for (u32 attempt = 0; attempt < 16; attempt++) {
+        char name[64] = {0};
+        snprintf(name, sizeof(name), "/bobtail_repeat_%ld_%u", (long)getpid(), atomic_fetch_add(&counter, 1));
+        // O_EXCL makes sure we never pick up someone else's file, like one a
+        // crashed process with the same PID left behind
+        const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd != -1) {
+            shm_unlink(name);
+            return fd;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+    return -1;
+}
+
+u32 vmem_repeat_granularity() {
+    return VMEM_PAGE_SIZE;
+}
+
+void* vmem_create_repeat_mapping_pages(u32 ring_pages, u32 repeat_count) {
+    const u64 ring_size = (u64)ring_pages * VMEM_PAGE_SIZE;
+    const u64 mapping_size = ring_size * repeat_count;
+    if (ring_size == 0 || repeat_count == 0 || mapping_size / repeat_count != ring_size || mapping_size > SIZE_MAX) {
+        LOG_MSG(error, "Bad repeat mapping size [0x%X pages x %u]\n", ring_pages, repeat_count);
+        return NULL;
+    }
+
     // To trick mmap() into mapping the same region to consecutive virtual
     // regions, we create a virtual (in-memory) file as a backing buffer.
-    const char* vfile_name = "_repeatmap_vfile";
-    // If we crashed during this function or something, the file could be left
-    // behind in memory from a previous run, so we delete it first.
-    shm_unlink(vfile_name);
-    int ramfile = shm_open(vfile_name, O_RDWR | O_CREAT, 0);
-    ftruncate(ramfile, VMEM_ALLOC_GRANULARITY * ring_width); // Extend the file to this size
+    const int ramfile = vmem_anonymous_file();
+    if (ramfile == -1) {
+        LOG_MSG(error, "Couldn't create a backing file for the repeat mapping\n");
+        return NULL;
+    }
+    if (ftruncate(ramfile, (off_t)ring_size) != 0) {
+        LOG_MSG(error, "Couldn't resize repeat mapping file to 0x%llX bytes\n", (unsigned long long)ring_size);
+        close(ramfile);
+        return NULL;
+    }
 
     // Reserve enough virtual address space to hold the whole repeat mapping
-    const u64 mapping_size = (u64)VMEM_ALLOC_GRANULARITY * (u64)ring_width * (u64)repeat_count;
-    if (mapping_size == 0) {
-        printf("Likely integer overflow or bad user input!\n");
-    }
-    void* mapbase = mmap(NULL, mapping_size, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
-    if (mapbase == NULL) {
+    u8* mapbase = mmap(NULL, mapping_size, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (mapbase == MAP_FAILED) {
+        close(ramfile);
         return NULL;
     }
 
     // Map the same virtual file multiple times into adjacent virtual pages,
-    // so that writing to one mapping affects all of them
+    // so that writing to one mapping affects all of them. MAP_FIXED replaces
+    // our reservation, so no one else can grab the address range in between.
     for (u32 i = 0; i < repeat_count; i++) {
-        const uintptr_t offset = (u64)i * (u64)VMEM_ALLOC_GRANULARITY * (u64)ring_width;
-        void* cur_map_pos = (void*)((uintptr_t)mapbase + offset);
-        void* mapping = mmap(cur_map_pos, ring_width * VMEM_ALLOC_GRANULARITY, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED, ramfile, 0);
+        void* mapping = mmap(mapbase + (i * ring_size), ring_size, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED, ramfile, 0);
         if (mapping == MAP_FAILED) {
+            // This unmaps the views we made and the rest of the reservation
+            munmap(mapbase, mapping_size);
+            close(ramfile);
             return NULL;
         }
     }
 
-    // Once the file is mapped, we can delete it from the virtual filesystem
-    // and our mappings aren't affected.
-    shm_unlink(vfile_name);
+    // The mappings keep the file alive, so we don't need the descriptor anymore
+    close(ramfile);
     return mapbase;
 }
 
+void vmem_destroy_repeat_mapping_pages(void* base_addr, u32 ring_pages, u32 repeat_count) {
+    munmap(base_addr, (u64)ring_pages * VMEM_PAGE_SIZE * repeat_count);
+}
+
+void* vmem_create_repeat_mapping(u32 ring_width, u32 repeat_count) {
+    const u64 ring_pages = (u64)ring_width * (VMEM_ALLOC_GRANULARITY / VMEM_PAGE_SIZE);
+    if (ring_pages > UINT32_MAX) {
+        return NULL;
+    }
+    return vmem_create_repeat_mapping_pages((u32)ring_pages, repeat_count);
+}
+
 void vmem_destroy_repeat_mapping(void* base_addr, u32 ring_width, u32 repeat_count) {
-    u64 size = ring_width * VMEM_ALLOC_GRANULARITY * repeat_count;
-    munmap(base_addr, size);
+    vmem_destroy_repeat_mapping_pages(base_addr, ring_width * (VMEM_ALLOC_GRANULARITY / VMEM_PAGE_SIZE), repeat_count);
 }
 
 void* vmem_reserve(u64 size) {
@@ -69,7 +137,10 @@ int vmem_commit(void* addr, u64 size) {
     // The kernel will automatically commit physical memory as needed when we
     // write to the region. However, here we edit the existing mapping to let
     // it reserve space in the page file.
-    void* retval = mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    // MAP_FIXED is needed to actually replace the reserved pages. Without it,
+    // the address is only a hint, and since it's already taken the kernel
+    // would just hand us (and leak) a brand new mapping somewhere else.
+    void* retval = mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
     if (retval != MAP_FAILED) {
 	    return 0;
     }
@@ -0,0 +1,175 @@
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "logging.h"
+#include "thread.h"
+#include "vmem.h"
+#include "vfile.h"
+#include "vmem_ring.h"
+
+enum {
+    /// Number of views in the mapping. 2 is enough for any run up to the
+    /// ring size to be contiguous.
+    VMEM_RING_VIEWS = 2,
+};
+
+/// Address of a (not yet wrapped) stream position in the first view
+static inline u8* vmem_ring_at(const vmem_ring* r, u64 pos) {
+    return r->data + (pos % r->size);
+}
+
+vmem_ring vmem_ring_create(csize min_size) {
+    const u64 granularity = vmem_repeat_granularity();
+    const u64 size = MAX(((u64)min_size + granularity - 1) / granularity, 1) * granularity;
+    const u64 pages = size / VMEM_PAGE_SIZE;
+    if (size * VMEM_RING_VIEWS > CSIZE_MAX || pages > UINT32_MAX) {
+        LOG_MSG(error, "Can't make a 0x%llX byte ring\n", (unsigned long long)min_size);
+        return (vmem_ring){0};
+    }
+
+    u8* data = vmem_create_repeat_mapping_pages((u32)pages, VMEM_RING_VIEWS);
+    if (data == NULL) {
+        LOG_MSG(error, "Couldn't create a 0x%llX byte repeat mapping\n", (unsigned long long)size);
+        return (vmem_ring){0};
+    }
+    vmem_ring r = {
+        .data = data,
+        .size = size,
+    };
+    atomic_init(&r.write_pos, 0);
+    atomic_init(&r.write_seq, 0);
+    atomic_init(&r.closed, false);
+    atomic_init(&r.read_pos, 0);
+    atomic_init(&r.read_seq, 0);
+    atomic_init(&r.reader_waiting, 0);
+    atomic_init(&r.writer_waiting, 0);
+    return r;
+}
+
+void vmem_ring_destroy(vmem_ring* r) {
+    u8* data = r->data;
+    const u32 pages = r->size / VMEM_PAGE_SIZE;
+    *r = (vmem_ring){0};
+    if (data != NULL) {
+        vmem_destroy_repeat_mapping_pages(data, pages, VMEM_RING_VIEWS);
+    }
+}
+
+csize vmem_ring_write_space(vmem_ring* r) {
+    const u64 write = atomic_load_explicit(&r->write_pos, memory_order_relaxed);
+    const u64 read = atomic_load_explicit(&r->read_pos, memory_order_acquire);
+    return r->size - (csize)(write - read);
+}
+
+u8* vmem_ring_write_reserve(vmem_ring* r, csize size) {
+    if (size > vmem_ring_write_space(r)) {
+        return NULL;
+    }
+    return vmem_ring_at(r, atomic_load_explicit(&r->write_pos, memory_order_relaxed));
+}
+
+void vmem_ring_write_commit(vmem_ring* r, csize size) {
+    const u64 write = atomic_load_explicit(&r->write_pos, memory_order_relaxed);
+    atomic_store_explicit(&r->write_pos, write + size, memory_order_release);
+    // Bump the sequence before checking for a sleeper. Either the reader sees
+    // the new sequence & doesn't sleep, or we see the reader & wake it.
+    atomic_fetch_add(&r->write_seq, 1);
+    if (atomic_load(&r->reader_waiting) != 0) {
+        thread_wake_one(&r->write_seq);
+    }
+}
+
+void vmem_ring_close(vmem_ring* r) {
+    atomic_store(&r->closed, true);
+    atomic_fetch_add(&r->write_seq, 1);
+    thread_wake_one(&r->write_seq);
+}
+
+const u8* vmem_ring_read_peek(vmem_ring* r, csize* available) {
+    const u64 read = atomic_load_explicit(&r->read_pos, memory_order_relaxed);
+    const u64 write = atomic_load_explicit(&r->write_pos, memory_order_acquire);
+    *available = (csize)(write - read);
+    return vmem_ring_at(r, read);
+}
+
+void vmem_ring_read_consume(vmem_ring* r, csize size) {
+    const u64 read = atomic_load_explicit(&r->read_pos, memory_order_relaxed);
+    const u64 write = atomic_load_explicit(&r->write_pos, memory_order_acquire);
+    size = (csize)MIN(size, write - read);
+    atomic_store_explicit(&r->read_pos, read + size, memory_order_release);
+    atomic_fetch_add(&r->read_seq, 1);
+    if (atomic_load(&r->writer_waiting) != 0) {
+        thread_wake_one(&r->read_seq);
+    }
+}
+
+bool vmem_ring_read_eof(vmem_ring* r) {
+    // Check closed first, so a commit right before closing isn't missed
+    if (!atomic_load(&r->closed)) {
+        return false;
+    }
+    csize available = 0;
+    vmem_ring_read_peek(r, &available);
+    return available == 0;
+}
+
+/// Milliseconds left until a timeout runs out, or 0 if it's over
+static u32 vmem_ring_remaining(u64 start, u32 timeout_ms) {
+    if (timeout_ms == THREAD_WAIT_FOREVER) {
+        return THREAD_WAIT_FOREVER;
+    }
+    const u64 elapsed = thread_time_ms() - start;
+    return (elapsed >= timeout_ms) ? 0 : (u32)(timeout_ms - elapsed);
+}
+
+bool vmem_ring_read_wait(vmem_ring* r, csize size, u32 timeout_ms) {
+    const u64 start = thread_time_ms();
+    while (true) {
+        atomic_store(&r->reader_waiting, 1);
+        const u32 seq = atomic_load(&r->write_seq);
+        // Read closed before the position, so the last commit before closing
+        // is always seen
+        const bool closed = atomic_load(&r->closed);
+        csize available = 0;
+        vmem_ring_read_peek(r, &available);
+        if (available >= size) {
+            atomic_store(&r->reader_waiting, 0);
+            return true;
+        }
+        const u32 remaining = vmem_ring_remaining(start, timeout_ms);
+        if (closed || remaining == 0) {
+            atomic_store(&r->reader_waiting, 0);
+            return false;
+        }
+        thread_wait(&r->write_seq, seq, remaining);
+    }
+}
+
+bool vmem_ring_write_wait(vmem_ring* r, csize size, u32 timeout_ms) {
+    if (size > r->size) {
+        return false;
+    }
+    const u64 start = thread_time_ms();
+    while (true) {
+        atomic_store(&r->writer_waiting, 1);
+        const u32 seq = atomic_load(&r->read_seq);
+        if (vmem_ring_write_space(r) >= size) {
+            atomic_store(&r->writer_waiting, 0);
+            return true;
+        }
+        const u32 remaining = vmem_ring_remaining(start, timeout_ms);
+        if (remaining == 0) {
+            atomic_store(&r->writer_waiting, 0);
+            return false;
+        }
+        thread_wait(&r->read_seq, seq, remaining);
+    }
+}
+
+vfile vmem_ring_read_vfile(vmem_ring* r) {
+    csize available = 0;
+    u8* ptr = (u8*)vmem_ring_read_peek(r, &available);
+    // vfiles are limited to 32-bit sizes
+    return vfile_open(ptr, (u32)MIN(available, UINT32_MAX));
+}
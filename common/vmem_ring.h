@@ -0,0 +1,142 @@
+#ifndef VMEM_RING_H
+#define VMEM_RING_H
+/// @file vmem_ring.h
+/// @brief Zero-copy byte stream between 1 producer thread & 1 consumer thread
+///
+/// A byte ring backed by a 2-view repeat mapping (see
+/// @ref vmem_create_repeat_mapping_pages()). Because the second view is the
+/// start of the ring again, any run of free or filled bytes is one contiguous
+/// range of memory, even when it wraps. So instead of copying data in & out,
+/// each side asks for a pointer:
+///
+/// - The producer calls @ref vmem_ring_write_reserve() to get space, writes
+///   into it directly (e.g. with read()/fread()), then publishes it with
+///   @ref vmem_ring_write_commit().
+/// - The consumer calls @ref vmem_ring_read_peek() to see everything that's
+///   been published, parses it in place, then frees what it used with
+///   @ref vmem_ring_read_consume().
+///
+/// @ref vmem_ring_read_vfile() wraps the readable bytes in a @ref vfile, so
+/// existing vfile parsers can read straight out of the ring.
+///
+/// Positions are published with release/acquire atomics, like
+/// @ref queue_spsc. Either side can sleep until there's enough data/space,
+/// and the producer can close the stream to signal the end.
+///
+/// @warning Exactly 1 thread can write and exactly 1 thread can read.
+/// @note Not available on Nintendo Switch, which can't make repeat mappings.
+/// @sa ring_queue.h, vmem.h
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "int.h"
+#include "thread.h"
+#include "vfile.h"
+
+/// @brief A single-producer/single-consumer byte stream
+///
+/// @warning Create & destroy aren't thread-safe.
+typedef struct {
+    /// Start of the repeat mapping (2 views of the ring)
+    u8* data;
+    /// Size of the ring in bytes (one view)
+    csize size;
+    u8 pad0[CACHE_LINE_SIZE];
+
+    /// Total bytes ever committed. Only the producer writes this.
+    _Atomic(u64) write_pos;
+    /// Bumped on every commit & on close. Readers sleep on it.
+    _Atomic(u32) write_seq;
+    /// Set when the producer is done
+    _Atomic(bool) closed;
+    u8 pad1[CACHE_LINE_SIZE];
+
+    /// Total bytes ever consumed. Only the consumer writes this.
+    _Atomic(u64) read_pos;
+    /// Bumped on every consume. Writers sleep on it.
+    _Atomic(u32) read_seq;
+    u8 pad2[CACHE_LINE_SIZE];
+
+    /// Whether each side is asleep (or about to be), so the other side only
+    /// makes the wake syscall when it's needed
+    _Atomic(u32) reader_waiting;
+    _Atomic(u32) writer_waiting;
+}vmem_ring;
+
+/// @brief Create a byte ring.
+/// @param min_size Minimum size of the ring in bytes. This is rounded up to a
+/// multiple of @ref vmem_repeat_granularity() (a page on POSIX).
+/// @return A new empty ring, with a NULL @ref vmem_ring.data on failure.
+/// @sa vmem_ring_destroy
+vmem_ring vmem_ring_create(csize min_size);
+
+/// @brief Free the mapping & fill all fields with 0.
+/// @warning Neither side can be using the ring.
+void vmem_ring_destroy(vmem_ring* r);
+
+/// @brief Number of bytes the producer can reserve right now
+csize vmem_ring_write_space(vmem_ring* r);
+
+/// @brief Get a contiguous block of @p size bytes to write into.
+///
+/// Nothing is visible to the reader until @ref vmem_ring_write_commit().
+/// Reserving again without committing gives back the same pointer.
+/// @param r The ring
+/// @param size Number of bytes to reserve. Can't be more than the ring size.
+/// @return Pointer to write to, or NULL if there isn't that much free space
+/// @sa vmem_ring_write_wait
+u8* vmem_ring_write_reserve(vmem_ring* r, csize size);
+
+/// @brief Publish the first @p size bytes of the last reservation to the
+/// reader, waking it if it's asleep.
+void vmem_ring_write_commit(vmem_ring* r, csize size);
+
+/// @brief Wait until at least @p size bytes can be reserved.
+/// @param r The ring
+/// @param size Number of bytes needed
+/// @param timeout_ms Max time to wait, or @ref THREAD_WAIT_FOREVER
+/// @return False if the timeout ran out first
+bool vmem_ring_write_wait(vmem_ring* r, csize size, u32 timeout_ms);
+
+/// @brief Mark the end of the stream, & wake the reader. Only the producer
+/// can call this, and it can't write anything afterwards.
+void vmem_ring_close(vmem_ring* r);
+
+/// @brief Get everything that's been committed & not consumed yet.
+/// @param r The ring
+/// @param available Where to write the number of readable bytes
+/// @return Pointer to the readable bytes, which are all contiguous
+const u8* vmem_ring_read_peek(vmem_ring* r, csize* available);
+
+/// @brief Free the first @p size readable bytes for the producer to reuse,
+/// waking it if it's asleep.
+void vmem_ring_read_consume(vmem_ring* r, csize size);
+
+/// @brief Wait until at least @p size bytes are readable.
+/// @param r The ring
+/// @param size Number of bytes needed
+/// @param timeout_ms Max time to wait, or @ref THREAD_WAIT_FOREVER
+/// @return False if the timeout ran out, or the stream was closed with fewer
+/// than @p size bytes left
+bool vmem_ring_read_wait(vmem_ring* r, csize size, u32 timeout_ms);
+
+/// @brief Whether the stream is closed and every byte has been consumed.
+bool vmem_ring_read_eof(vmem_ring* r);
+
+/// @brief Wrap the readable bytes in a @ref vfile, so they can be parsed in
+/// place.
+///
+/// Once you're done parsing, pass the vfile's position to
+/// @ref vmem_ring_read_consume() to free what was read.
+/// @code
+/// vfile f = vmem_ring_read_vfile(&ring);
+/// while (f.size - f.pos >= sizeof(u32)) {
+///     const u32 val = VFILE_READ(u32, &f);
+///     ...
+/// }
+/// vmem_ring_read_consume(&ring, f.pos);
+/// @endcode
+vfile vmem_ring_read_vfile(vmem_ring* r);
+
+#endif // #ifndef VMEM_RING_H
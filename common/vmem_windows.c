@@ -6,6 +6,7 @@
 #include <Windows.h>
 #include <stdlib.h> // For NULL
 #include "int.h"
+#include "logging.h"
 #include "vmem.h"
 
 // Non-thread-safe version that may have to be retried a few times if a race
@@ -13,12 +14,12 @@
 // VirtualAlloc2() and MapViewOfFile3() aren't available. Fabian Giesen's post
 // has more details:
 // https://fgiesen.wordpress.com/2012/07/21/the-magic-ring-buffer/
-void* repeat_mapping_fallback(u32 ring_width, u32 repeat_count) {
-    const u64 ring_size = ring_width * VMEM_ALLOC_GRANULARITY;
+static void* repeat_mapping_fallback(u64 ring_size, u32 repeat_count) {
     const u64 mapping_size = ring_size * repeat_count;
-    // Create initial file mapping, backed only by the page file
-    HANDLE file_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, mapping_size << 32, mapping_size & UINT32_MAX, NULL);
-    if (file_mapping == INVALID_HANDLE_VALUE) {
+    // Create initial file mapping, backed only by the page file. It's only
+    // one ring big, the views are what repeat it.
+    HANDLE file_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(ring_size >> 32), (DWORD)(ring_size & UINT32_MAX), NULL);
+    if (file_mapping == NULL) {
         return NULL;
     }
 
@@ -27,29 +28,43 @@ void* repeat_mapping_fallback(u32 ring_width, u32 repeat_count) {
     // our mapping
     void* base_addr = VirtualAlloc(NULL, mapping_size, MEM_RESERVE, PAGE_NOACCESS);
     if (base_addr == NULL) {
+        CloseHandle(file_mapping);
         return NULL;
     }
     VirtualFree(base_addr, 0, MEM_RELEASE);
     // Everything after this free call is a potential race condition
 
     for (u32 i = 0; i < repeat_count; i++) {
-        const uintptr_t offset = ring_size * i;
-        void* target_region = (void*)((uintptr_t)base_addr + offset);
-
+        void* target_region = (void*)((uintptr_t)base_addr + (ring_size * i));
         const void* mapping = MapViewOfFileEx(file_mapping, FILE_MAP_ALL_ACCESS, 0, 0, ring_size, target_region);
         if (mapping == NULL) {
-            // Clean up
-            vmem_destroy_repeat_mapping(base_addr, ring_width, repeat_count);
+            // Clean up the views we did make
+            for (u32 j = 0; j < i; j++) {
+                UnmapViewOfFile((void*)((uintptr_t)base_addr + (ring_size * j)));
+            }
             CloseHandle(file_mapping);
             return NULL;
         }
     }
 
-    // File has been mapped, return base pointer
+    // The views keep the file mapping alive, so we don't need the handle
+    CloseHandle(file_mapping);
     return base_addr;
 }
 
-void* vmem_create_repeat_mapping(u32 ring_width, u32 repeat_count) {
+u32 vmem_repeat_granularity() {
+    return VMEM_ALLOC_GRANULARITY;
+}
+
+void* vmem_create_repeat_mapping_pages(u32 ring_pages, u32 repeat_count) {
+    const u64 ring_size = (u64)ring_pages * VMEM_PAGE_SIZE;
+    const u64 mapping_size = ring_size * repeat_count;
+    // Views can only start on allocation granularity boundaries
+    if (ring_size == 0 || repeat_count == 0 || ring_size % VMEM_ALLOC_GRANULARITY != 0 || mapping_size / repeat_count != ring_size) {
+        LOG_MSG(error, "Bad repeat mapping size [0x%X pages x %u]\n", ring_pages, repeat_count);
+        return NULL;
+    }
+
     u8 num_attempts = 42;
     void* addr = NULL;
     // Introducing our (ryg's) innovative solution to rare race conditions:
@@ -59,25 +74,28 @@ void* vmem_create_repeat_mapping(u32 ring_width, u32 repeat_count) {
         // TODO: Use the thread-safe, guaranteed method shown by Casey Muratori.
         // After all, it's not much of a "fallback" if it's the only method :P
         // https://www.computerenhance.com/p/powerful-page-mapping-techniques
-        addr = repeat_mapping_fallback(ring_width, repeat_count);
+        addr = repeat_mapping_fallback(ring_size, repeat_count);
     }
     return addr;
 }
 
-void vmem_destroy_repeat_mapping(void* base_addr, u32 ring_width, u32 repeat_count) {
-    // If this is called to clean up after a mapping failure, a lot of these
-    // calls will fail because those regions were never mapped. But that's "ok"
-    // since it's not a fatal error.
-    const u64 ring_size = ring_width * VMEM_ALLOC_GRANULARITY;
+void vmem_destroy_repeat_mapping_pages(void* base_addr, u32 ring_pages, u32 repeat_count) {
+    const u64 ring_size = (u64)ring_pages * VMEM_PAGE_SIZE;
     for (u32 j = 0; j < repeat_count; j++) {
-        const uintptr_t unmap_offset = ring_size * j;
-        void* unmap_region = (void*) ((uintptr_t) base_addr + unmap_offset);
-        UnmapViewOfFile(unmap_region);
+        UnmapViewOfFile((void*)((uintptr_t)base_addr + (ring_size * j)));
     }
-    // TODO: What do we do about the leftover mapped file? OS-specific context
-    // struct? Maybe a 64-bit "mapping metadata" field to keep it around without
-    // making people think the mapping goes to disk?
-    // CloseHandle(file_mapping);
+}
+
+void* vmem_create_repeat_mapping(u32 ring_width, u32 repeat_count) {
+    const u64 ring_pages = (u64)ring_width * (VMEM_ALLOC_GRANULARITY / VMEM_PAGE_SIZE);
+    if (ring_pages > UINT32_MAX) {
+        return NULL;
+    }
+    return vmem_create_repeat_mapping_pages((u32)ring_pages, repeat_count);
+}
+
+void vmem_destroy_repeat_mapping(void* base_addr, u32 ring_width, u32 repeat_count) {
+    vmem_destroy_repeat_mapping_pages(base_addr, ring_width * (VMEM_ALLOC_GRANULARITY / VMEM_PAGE_SIZE), repeat_count);
 }
 
 // This API mimics VirtualAlloc() so it's a thin wrapper, not much to say here.
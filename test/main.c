@@ -3,19 +3,59 @@
 #include <common/int.h>
 #include <common/logging.h>
 
+bool test_allocator();
 bool test_list();
+bool test_list_reserved();
+bool test_list_find();
+bool test_list_typed();
+bool test_list_remove();
+bool test_list_map_file();
+bool test_list_grow_limit();
+bool test_list_indexed();
+bool test_seglist();
+bool test_list_concurrent();
+bool test_list_sort();
 bool test_queue();
+bool test_ring_queue();
+bool test_queue_spsc();
+bool test_queue_mpmc();
+bool test_pqueue();
+bool test_queue_blocking();
+bool test_job();
+bool test_container_stats();
 bool test_sha1();
 bool test_crc32();
 bool test_vmem();
+bool test_vmem_ring();
+bool test_arena();
 
 typedef bool (*testproc)(void);
 testproc tests[] = {
+    test_allocator,
     test_list,
+    test_list_reserved,
+    test_list_find,
+    test_list_typed,
+    test_list_remove,
+    test_list_map_file,
+    test_list_grow_limit,
+    test_list_indexed,
+    test_seglist,
+    test_list_concurrent,
+    test_list_sort,
     test_queue,
+    test_ring_queue,
+    test_queue_spsc,
+    test_queue_mpmc,
+    test_pqueue,
+    test_queue_blocking,
+    test_job,
+    test_container_stats,
     test_sha1,
     test_crc32,
     test_vmem,
+    test_vmem_ring,
+    test_arena,
 };
 
 int main() {
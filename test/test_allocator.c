@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/int.h>
+#include <common/allocator.h>
+#include <common/list.h>
+#include <common/list_sort.h>
+#include <common/list_concurrent.h>
+#include <common/seglist.h>
+#include <common/queue.h>
+#include <common/file.h>
+
+#include "testing.h"
+
+/// Counts calls & live blocks, so we can check who allocated what
+typedef struct {
+    u32 allocs;
+    u32 reallocs;
+    u32 frees;
+    s32 live;
+}alloc_counter;
+
+static void* counting_alloc(void* ctx, size_t size) {
+    alloc_counter* c = ctx;
+    c->allocs++;
+    c->live++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    alloc_counter* c = ctx;
+    (void)old_size;
+    c->reallocs++;
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void* ctx, void* ptr) {
+    alloc_counter* c = ctx;
+    c->frees++;
+    c->live--;
+    free(ptr);
+}
+
+bool test_allocator() {
+    bool result = true;
+
+    alloc_counter counter = {0};
+    const allocator tracked = {
+        .alloc = counting_alloc,
+        .realloc = counting_realloc,
+        .free = counting_free,
+        .ctx = &counter,
+    };
+
+    // Per-container allocator
+    list l = list_create_alloc(sizeof(u32), sizeof(u32), &tracked);
+    for (u32 i = 0; i < 100; i++) {
+        list_add(&l, &i);
+    }
+    if (counter.allocs != 1 || counter.reallocs == 0) {
+        printf("LIST: Expected 1 alloc & some reallocs, got %u & %u\n", counter.allocs, counter.reallocs);
+        result = false;
+    }
+    for (u32 i = 0; i < 100; i++) {
+        if (*(u32*)list_get_element(l, i) != i) {
+            printf("LIST: Element %u was lost while growing!\n", i);
+            result = false;
+            break;
+        }
+    }
+    // Sort scratch space comes from the list's allocator too
+    const u32 allocs_before_sort = counter.allocs;
+    if (!list_radix_sort(&l, 0, sizeof(u32)) || counter.allocs == allocs_before_sort || counter.live != 1) {
+        printf("SORT: Scratch space didn't come from the list's allocator\n");
+        result = false;
+    }
+    list_destroy(&l);
+    if (counter.live != 0) {
+        printf("LIST: %d blocks leaked!\n", counter.live);
+        result = false;
+    }
+
+    queue q = queue_create_alloc(sizeof(u32), sizeof(u32), &tracked);
+    for (u32 i = 0; i < 100; i++) {
+        queue_add(&q, &i);
+    }
+    u32 front = 1;
+    if (!queue_get(&q, &front) || front != 0) {
+        printf("QUEUE: Got the wrong element after growing!\n");
+        result = false;
+    }
+    queue_destroy(&q);
+    if (counter.live != 0) {
+        printf("QUEUE: %d blocks leaked!\n", counter.live);
+        result = false;
+    }
+
+    // Containers keep the default they were created with, even if it changes
+    allocator_set_default(&tracked);
+    if (allocator_default() != &tracked) {
+        printf("DEFAULT: Default allocator wasn't changed!\n");
+        result = false;
+    }
+    seglist s = seglist_create(4, sizeof(u32));
+    list zeroed = {.element_size = sizeof(u32)};
+    list_concurrent lc = list_concurrent_create(4, sizeof(u32));
+    for (u32 i = 0; i < 20; i++) {
+        seglist_add(&s, &i);
+        list_add(&zeroed, &i);
+    }
+    const s32 live_before_chunks = counter.live;
+    for (u32 i = 0; i < 20; i++) {
+        list_concurrent_add(&lc, &i);
+    }
+    if (counter.live == live_before_chunks) {
+        printf("DEFAULT: Concurrent list chunks didn't come from the default allocator\n");
+        result = false;
+    }
+    allocator_set_default(NULL);
+    if (allocator_default() != &allocator_heap) {
+        printf("DEFAULT: Default allocator wasn't reset!\n");
+        result = false;
+    }
+    const u32 before = counter.allocs;
+    seglist_destroy(&s);
+    list_destroy(&zeroed);
+    list_concurrent_destroy(&lc);
+    if (counter.live != 0 || counter.allocs != before) {
+        printf("DEFAULT: Containers didn't stick with their allocator (%d blocks live)\n", counter.live);
+        result = false;
+    }
+
+    // Allocators without a realloc callback fall back to alloc + copy + free
+    const allocator no_realloc = {
+        .alloc = counting_alloc,
+        .free = counting_free,
+        .ctx = &counter,
+    };
+    u8* block = allocator_alloc(&no_realloc, 4);
+    memcpy(block, "abc", 4);
+    block = allocator_realloc(&no_realloc, block, 4, 64);
+    if (block == NULL || strcmp((char*)block, "abc") != 0) {
+        printf("REALLOC: Fallback lost the contents!\n");
+        result = false;
+    }
+    allocator_free(&no_realloc, block);
+    if (counter.live != 0) {
+        printf("REALLOC: %d blocks leaked!\n", counter.live);
+        result = false;
+    }
+
+    const char* path = "bobtail_test_allocator.txt";
+    FILE* f = fopen(path, "wb");
+    if (f != NULL) {
+        fputs("hello", f);
+        fclose(f);
+    }
+    u8* contents = file_load_alloc(path, &tracked);
+    if (contents == NULL || strcmp((char*)contents, "hello") != 0 || counter.live != 1) {
+        printf("FILE: Didn't load through the allocator!\n");
+        result = false;
+    }
+    allocator_free(&tracked, contents);
+    remove(path);
+
+    REPORT_RESULT(result);
+    return result;
+}
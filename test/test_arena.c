@@ -0,0 +1,128 @@
+#include <string.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/arena.h>
+#include <common/allocator.h>
+#include <common/list.h>
+#include <common/vmem.h>
+
+#include "testing.h"
+
+enum {
+    ARENA_RESERVE = 64 * 1024 * 1024,
+    ARENA_CHUNK = 3 * VMEM_PAGE_SIZE,
+};
+
+bool test_arena() {
+    bool result = true;
+
+    arena a = arena_create(ARENA_RESERVE, ARENA_CHUNK - 1);
+    if (a.base == NULL) {
+        printf("CREATE: Couldn't reserve an arena!\n");
+        return false;
+    }
+    if (a.commit_chunk != ARENA_CHUNK || a.committed != 0 || a.reserved % ARENA_CHUNK != 0) {
+        printf("CREATE: Chunk/reserve sizes weren't rounded up, or memory was committed early!\n");
+        result = false;
+    }
+
+    // Alignment is respected, & every block is usable
+    u8* prev_end = NULL;
+    const u64 alignments[] = {1, 2, 8, 16, 64, 4096};
+    for (u32 i = 0; i < ARRAY_SIZE(alignments); i++) {
+        u8* p = arena_alloc(&a, 13, alignments[i]);
+        if (p == NULL || (uintptr_t)p % alignments[i] != 0 || p < prev_end) {
+            printf("ALLOC: Bad block for alignment %llu!\n", (unsigned long long)alignments[i]);
+            result = false;
+            break;
+        }
+        memset(p, 0xAB, 13);
+        prev_end = p + 13;
+    }
+    if (arena_alloc(&a, 8, 3) != NULL) {
+        printf("ALLOC: Allowed a non power of 2 alignment!\n");
+        result = false;
+    }
+
+    // Memory is committed a chunk at a time, as it's reached
+    if (a.committed != ARENA_CHUNK) {
+        printf("COMMIT: Committed 0x%llX bytes, expected 0x%llX!\n", (unsigned long long)a.committed, (unsigned long long)ARENA_CHUNK);
+        result = false;
+    }
+
+    // Restoring a mark frees everything after it, and the space gets reused
+    const arena_mark mark = arena_save(&a);
+    u8* big = arena_alloc(&a, 5 * ARENA_CHUNK, 1);
+    if (big == NULL) {
+        printf("ALLOC: Couldn't allocate a multi-chunk block!\n");
+        return false;
+    }
+    memset(big, 0xCD, 5 * ARENA_CHUNK);
+    const u64 committed = a.committed;
+    arena_restore(&a, mark);
+    if (a.pos != mark.pos || arena_alloc(&a, 1, 1) != big || a.committed != committed) {
+        printf("RESTORE: Space after the mark wasn't reused!\n");
+        result = false;
+    }
+
+    // Reset goes back to the start, keeping the memory committed
+    arena_reset(&a);
+    u8* first = arena_alloc(&a, 1, 1);
+    if (first != a.base || a.committed != committed) {
+        printf("RESET: Arena didn't start over!\n");
+        result = false;
+    }
+
+    // Running out of reserved space fails instead of overrunning
+    if (arena_alloc(&a, a.reserved, 1) != NULL) {
+        printf("ALLOC: Allocated past the end of the reservation!\n");
+        result = false;
+    }
+
+    // Through the allocator interface, a list grows in place at the end
+    arena_reset(&a);
+    const allocator alloc = arena_allocator(&a);
+    u32* block = allocator_alloc(&alloc, sizeof(u32));
+    if (block == NULL || (uintptr_t)block % ARENA_DEFAULT_ALIGNMENT != 0) {
+        printf("ALLOCATOR: Bad block!\n");
+        result = false;
+    }
+    list l = list_create_alloc(4 * sizeof(u32), sizeof(u32), &alloc);
+    for (u32 i = 0; i < 10000; i++) {
+        list_add(&l, &i);
+    }
+    for (u32 i = 0; i < 10000; i++) {
+        if (*(u32*)list_get_element(l, i) != i) {
+            printf("ALLOCATOR: List lost element %u!\n", i);
+            result = false;
+            break;
+        }
+    }
+    // Since the list was the newest block every time, nothing was copied
+    // & the arena only holds the final buffer
+    if ((u8*)l.data != (u8*)block + ARENA_DEFAULT_ALIGNMENT || a.pos > (u64)((u8*)l.data - a.base) + l.alloc_size) {
+        printf("ALLOCATOR: List buffer wasn't grown in place!\n");
+        result = false;
+    }
+
+    // Resizing an older block has to copy it
+    *block = 0x12345678;
+    u32* moved = allocator_realloc(&alloc, block, sizeof(u32), 64);
+    if (moved == block || moved == NULL || *moved != 0x12345678) {
+        printf("ALLOCATOR: Older block wasn't copied on resize!\n");
+        result = false;
+    }
+    // Freeing is a no-op
+    allocator_free(&alloc, moved);
+    list_destroy(&l);
+
+    arena_destroy(&a);
+    if (a.base != NULL || a.reserved != 0) {
+        printf("DESTROY: Arena wasn't cleared!\n");
+        result = false;
+    }
+
+    REPORT_RESULT(result);
+    return result;
+}
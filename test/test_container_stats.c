@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/list.h>
+#include <common/list_typed.h>
+#include <common/queue.h>
+#include <common/container_stats.h>
+
+#include "testing.h"
+
+enum {
+    STATS_COUNT = 100,
+};
+
+bool test_container_stats() {
+    bool result = true;
+
+    list l = list_create(4 * sizeof(u32), sizeof(u32));
+    for (u32 i = 0; i < STATS_COUNT; i++) {
+        list_add(&l, &i);
+    }
+    list_remove_ordered(&l, 0);
+    container_stats stats = list_stats(l);
+
+    queue q = queue_create(4 * sizeof(u32), sizeof(u32));
+    for (u32 i = 0; i < STATS_COUNT; i++) {
+        queue_add(&q, &i);
+    }
+    container_stats qstats = queue_stats(q);
+
+    if (!container_stats_enabled()) {
+        // Nothing is counted, so everything has to read as 0
+        const container_stats zero = {0};
+        if (memcmp(&stats, &zero, sizeof(zero)) != 0 || memcmp(&qstats, &zero, sizeof(zero)) != 0) {
+            printf("DISABLED: Stats aren't zero when turned off!\n");
+            result = false;
+        }
+        list_destroy(&l);
+        queue_destroy(&q);
+        REPORT_RESULT(result);
+        return result;
+    }
+
+    if (stats.grow_count == 0 || stats.grow_bytes_copied == 0 || stats.peak_alloc_size != l.alloc_size) {
+        printf("LIST: Growth wasn't counted!\n");
+        result = false;
+    }
+    if (stats.peak_count != STATS_COUNT || stats.compact_bytes_moved != (STATS_COUNT - 1) * sizeof(u32)) {
+        printf("LIST: Wrong peak count or compaction bytes!\n");
+        result = false;
+    }
+
+    // Typed lists add inline without calling list_add(), and the peak has to
+    // survive the list shrinking again
+    list_u32 typed = list_u32_create(STATS_COUNT * 2);
+    for (u32 i = 0; i < STATS_COUNT; i++) {
+        list_u32_add(&typed, i);
+    }
+    list_u32_clear(&typed);
+    if (list_stats(typed.base).peak_count != STATS_COUNT) {
+        printf("LIST: Typed list adds weren't counted!\n");
+        result = false;
+    }
+    list_u32_destroy(&typed);
+
+    // The suggested size should be enough to never grow
+    list sized = list_create(stats.suggested_init_size, sizeof(u32));
+    for (u32 i = 0; i < STATS_COUNT; i++) {
+        list_add(&sized, &i);
+    }
+    if (list_stats(sized).grow_count != 0) {
+        printf("LIST: Suggested init size still had to grow!\n");
+        result = false;
+    }
+    container_stats_print("test_container_stats list", stats);
+
+    if (qstats.grow_count == 0 || qstats.peak_count != STATS_COUNT || qstats.peak_alloc_size != (u64)q.capacity * sizeof(u32)) {
+        printf("QUEUE: Wrong growth stats!\n");
+        result = false;
+    }
+    queue sized_q = queue_create(qstats.suggested_init_size, sizeof(u32));
+    for (u32 i = 0; i < STATS_COUNT; i++) {
+        queue_add(&sized_q, &i);
+    }
+    if (queue_stats(sized_q).grow_count != 0) {
+        printf("QUEUE: Suggested init size still had to grow!\n");
+        result = false;
+    }
+
+    queue_destroy(&sized_q);
+    list_destroy(&sized);
+    list_destroy(&l);
+    queue_destroy(&q);
+    REPORT_RESULT(result);
+    return result;
+}
@@ -0,0 +1,180 @@
+#include <stdlib.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/thread.h>
+#include <common/job.h>
+
+#include "testing.h"
+
+enum {
+    JOB_TEST_WORKERS = 3,
+    JOB_TEST_COUNT = 10000,
+    JOB_TEST_RANGE = 100000,
+    JOB_TEST_SUBMITTERS = 2,
+    /// Rounds of waiting on jobs slow enough to sleep on
+    JOB_TEST_SLEEPS = 20,
+};
+
+static void job_count(void* arg) {
+    atomic_fetch_add((_Atomic(u32)*)arg, 1);
+}
+
+/// Sums [begin, end) by splitting in half & running each half as a job, so
+/// jobs wait on their own sub-jobs.
+typedef struct {
+    u64 begin;
+    u64 end;
+    u64 sum;
+}job_tree;
+
+static void job_tree_sum(void* arg) {
+    job_tree* node = arg;
+    if (node->end - node->begin <= 16) {
+        for (u64 i = node->begin; i < node->end; i++) {
+            node->sum += i;
+        }
+        return;
+    }
+    const u64 mid = node->begin + ((node->end - node->begin) / 2);
+    job_tree left = { .begin = node->begin, .end = mid };
+    job_tree right = { .begin = mid, .end = node->end };
+    job_group group = {0};
+    job_submit(&group, job_tree_sum, &left);
+    job_tree_sum(&right);
+    job_wait(&group);
+    node->sum = left.sum + right.sum;
+}
+
+static void job_mark(void* arg, csize begin, csize end) {
+    _Atomic(u8)* visits = arg;
+    for (csize i = begin; i < end; i++) {
+        atomic_fetch_add(&visits[i], 1);
+    }
+}
+
+/// Takes long enough that job_wait() gives up spinning & goes to sleep
+static void job_slow(void* arg) {
+    _Atomic(u32) never = 0;
+    thread_wait(&never, 0, 2);
+    job_count(arg);
+}
+
+/// Submits jobs from a thread outside the pool
+static void job_submitter(void* arg) {
+    job_group group = {0};
+    for (u32 i = 0; i < JOB_TEST_COUNT; i++) {
+        job_submit(&group, job_count, arg);
+    }
+    job_wait(&group);
+}
+
+bool test_job() {
+    bool result = true;
+
+    // Use a few workers even on small machines, so stealing gets exercised
+    if (!job_system_init(JOB_TEST_WORKERS) || job_worker_count() != JOB_TEST_WORKERS) {
+        printf("INIT: Couldn't start the job system!\n");
+        result = false;
+    }
+
+    _Atomic(u32) counter = 0;
+    job_group group = {0};
+    for (u32 i = 0; i < JOB_TEST_COUNT; i++) {
+        job_submit(&group, job_count, &counter);
+    }
+    job_wait(&group);
+    if (atomic_load(&counter) != JOB_TEST_COUNT) {
+        printf("SUBMIT: %u of %u jobs ran before the wait returned!\n", atomic_load(&counter), JOB_TEST_COUNT);
+        result = false;
+    }
+
+    // Waiting on an empty group, or reusing one, should just work
+    job_wait(&group);
+    job_submit(&group, job_count, &counter);
+    job_wait(&group);
+    if (atomic_load(&counter) != JOB_TEST_COUNT + 1) {
+        printf("SUBMIT: Reused group didn't run its job!\n");
+        result = false;
+    }
+
+    // Fork-join, with jobs waiting on the jobs they spawned
+    job_tree root = { .begin = 0, .end = JOB_TEST_RANGE };
+    job_tree_sum(&root);
+    if (root.sum != ((u64)JOB_TEST_RANGE * (JOB_TEST_RANGE - 1)) / 2) {
+        printf("NESTED: Wrong sum from nested jobs!\n");
+        result = false;
+    }
+
+    // Every index has to be visited exactly once, with odd grains & counts
+    _Atomic(u8)* visits = calloc(JOB_TEST_RANGE, sizeof(*visits));
+    const csize grains[] = { 0, 1, 7, 1000, JOB_TEST_RANGE * 2 };
+    for (u32 g = 0; g < ARRAY_SIZE(grains); g++) {
+        const csize count = JOB_TEST_RANGE - g;
+        job_parallel_for(count, grains[g], job_mark, (void*)visits);
+        for (csize i = 0; i < JOB_TEST_RANGE; i++) {
+            const u8 expected = (i < count) ? 1 : 0;
+            if (atomic_load(&visits[i]) != expected) {
+                printf("PARALLEL_FOR: Index %u visited %u times with grain %u!\n", (u32)i, atomic_load(&visits[i]), (u32)grains[g]);
+                result = false;
+                break;
+            }
+        }
+        for (csize i = 0; i < JOB_TEST_RANGE; i++) {
+            atomic_store(&visits[i], 0);
+        }
+    }
+    free(visits);
+
+    // Several outside threads submitting at once
+    atomic_store(&counter, 0);
+    thread threads[JOB_TEST_SUBMITTERS] = {0};
+    for (u32 i = 0; i < ARRAY_SIZE(threads); i++) {
+        if (!thread_create(&threads[i], job_submitter, (void*)&counter)) {
+            printf("THREAD: Couldn't start thread!\n");
+            return false;
+        }
+    }
+    for (u32 i = 0; i < ARRAY_SIZE(threads); i++) {
+        thread_join(threads[i]);
+    }
+    if (atomic_load(&counter) != JOB_TEST_COUNT * JOB_TEST_SUBMITTERS) {
+        printf("THREAD: Lost jobs from outside threads!\n");
+        result = false;
+    }
+
+    // A group that's freed as soon as the wait returns, after the waiter
+    // went to sleep. The last job mustn't touch it after that (which ASan
+    // would catch).
+    atomic_store(&counter, 0);
+    for (u32 i = 0; i < JOB_TEST_SLEEPS; i++) {
+        job_group* heap_group = calloc(1, sizeof(*heap_group));
+        for (u32 j = 0; j < JOB_TEST_WORKERS + 1; j++) {
+            job_submit(heap_group, job_slow, &counter);
+        }
+        job_wait(heap_group);
+        free(heap_group);
+    }
+    if (atomic_load(&counter) != JOB_TEST_SLEEPS * (JOB_TEST_WORKERS + 1)) {
+        printf("SLEEP: Wait returned before the slow jobs finished!\n");
+        result = false;
+    }
+
+    // Shutting down & starting again on first use
+    job_system_shutdown();
+    if (job_worker_count() != 0) {
+        printf("SHUTDOWN: Workers still running!\n");
+        result = false;
+    }
+    atomic_store(&counter, 0);
+    job_submit(&group, job_count, &counter);
+    job_wait(&group);
+    if (atomic_load(&counter) != 1) {
+        printf("RESTART: Job didn't run after restarting!\n");
+        result = false;
+    }
+    job_system_shutdown();
+
+    REPORT_RESULT(result);
+    return result;
+}
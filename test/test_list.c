@@ -1,6 +1,12 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <common/logging.h>
 #include <common/int.h>
 #include <common/list.h>
+#include <common/list_typed.h>
+#include <common/file.h>
 
 #include "testing.h"
 
@@ -81,6 +87,474 @@ bool test_list() {
         result = false;
     }
 
+    // Bulk add should append everything in order
+    const u16 many[] = {100, 101, 102, 103, 104, 105, 106, 107, 108, 109};
+    const u32 old_end = l.end_idx;
+    list_add_many(&l, many, ARRAY_SIZE(many));
+    if (l.end_idx != old_end + ARRAY_SIZE(many)) {
+        printf("ADD_MANY: end_idx not incremented correctly!\n");
+        result = false;
+    }
+    for (u32 i = 0; i < ARRAY_SIZE(many); i++) {
+        if (*(u16*)list_get_element(l, old_end + i) != many[i]) {
+            printf("ADD_MANY: element %d is wrong!\n", i);
+            result = false;
+            break;
+        }
+    }
+
+    // Reserving should grow once, and then adds shouldn't realloc
+    list reserved = list_create(4, sizeof(u16));
+    if (!list_reserve(&reserved, 64)) {
+        printf("RESERVE: failed to grow!\n");
+        result = false;
+    }
+    const u32 reserved_size = reserved.alloc_size;
+    for (u16 i = 0; i < 64; i++) {
+        list_add(&reserved, &i);
+    }
+    if (reserved.alloc_size != reserved_size) {
+        printf("RESERVE: list grew even though space was reserved!\n");
+        result = false;
+    }
+
+    // Merge should copy all of src onto the end of dest, in order
+    const u32 dest_end = l.end_idx;
+    list_merge(&l, reserved);
+    if (l.end_idx != dest_end + reserved.end_idx) {
+        printf("MERGE: end_idx not incremented correctly!\n");
+        result = false;
+    }
+    if (memcmp(list_get_element(l, dest_end), (void*)reserved.data, reserved.end_idx * sizeof(u16)) != 0) {
+        printf("MERGE: merged data doesn't match!\n");
+        result = false;
+    }
+    list_destroy(&reserved);
+
+    // Clearing shouldn't touch the buffer, and clear_zero should wipe it
+    const csize cleared_size = l.alloc_size;
+    list_clear(&l);
+    if (l.end_idx != 0 || l.alloc_size != cleared_size || !list_empty(l)) {
+        printf("CLEAR: list wasn't reset properly!\n");
+        result = false;
+    }
+    list_add(&l, &val);
+    list_clear_zero(&l);
+    if (l.end_idx != 0 || *(u16*)list_get_element(l, 0) != 0) {
+        printf("CLEAR_ZERO: buffer wasn't zeroed!\n");
+        result = false;
+    }
+
+    // Shrinking should leave just enough room for the current elements
+    for (u16 i = 0; i < 5; i++) {
+        list_add(&l, &i);
+    }
+    if (!list_shrink_to_fit(&l) || l.alloc_size != 6 * sizeof(u16)) {
+        printf("SHRINK: buffer wasn't shrunk!\n");
+        result = false;
+    }
+    if (*(u16*)list_get_element(l, 4) != 4) {
+        printf("SHRINK: lost data while shrinking!\n");
+        result = false;
+    }
+    // A count whose size doesn't fit in a csize has to be refused, not
+    // wrapped around to a tiny buffer
+    const csize real_end = l.end_idx;
+    const csize real_size = l.alloc_size;
+    l.end_idx = (CSIZE_MAX / sizeof(u16)) + 1;
+    if (list_shrink_to_fit(&l) || l.alloc_size != real_size) {
+        printf("SHRINK: Overflowing size wasn't refused!\n");
+        result = false;
+    }
+    l.end_idx = real_end;
+
+    // A custom growth factor should be used for the next growth
+    list_set_growth(&l, 4.0f);
+    const csize shrunk_size = l.alloc_size;
+    list_add(&l, &val);
+    if (l.alloc_size < shrunk_size * 4) {
+        printf("GROWTH: custom growth factor wasn't used!\n");
+        result = false;
+    }
+    list_destroy(&l);
+
+    REPORT_RESULT(result);
+    return result;
+}
+
+bool test_list_reserved() {
+    bool result = true;
+
+    // 1GiB of address space, which we should never come close to touching
+    const u64 reserve_size = exponent(1024, 3);
+    list l = list_create_reserved(reserve_size, sizeof(u32));
+    if ((void*)l.data == NULL) {
+        printf("CREATE: Reservation failed!\n");
+        return false;
+    }
+    if (l.reserve_size != reserve_size) {
+        printf("CREATE: reserve size init wrong!\n");
+        result = false;
+    }
+
+    // Hold a pointer across growth, which should be safe for reserved lists
+    const u32 first = 0xB0B7A11;
+    list_add(&l, &first);
+    const u32* first_ptr = list_get_element(l, 0);
+    const u32 init_alloc = l.alloc_size;
+
+    // Enough to cross a bunch of page boundaries
+    const u32 count = 100000;
+    for (u32 i = 1; i < count; i++) {
+        list_add(&l, &i);
+    }
+    if (l.alloc_size <= init_alloc) {
+        printf("ADD: didn't commit more pages!\n");
+        result = false;
+    }
+    if (l.end_idx != count) {
+        printf("ADD: end_idx not incremented correctly!\n");
+        result = false;
+    }
+    if (first_ptr != list_get_element(l, 0) || *first_ptr != first) {
+        printf("ADD: buffer moved during growth!\n");
+        result = false;
+    }
+    for (u32 i = 1; i < count; i++) {
+        if (*(u32*)list_get_element(l, i) != i) {
+            printf("ADD: element %d is wrong after growth!\n", i);
+            result = false;
+            break;
+        }
+    }
+
+    list_destroy(&l);
+    if ((void*)l.data != NULL || l.reserve_size != 0) {
+        printf("DESTROY: list wasn't zeroed!\n");
+        result = false;
+    }
+
+    REPORT_RESULT(result);
+    return result;
+}
+
+bool test_list_find() {
+    bool result = true;
+
+    // Covers every vectorized width, plus a few that use the generic search.
+    // 200 elements means we hit full blocks and a leftover tail every time.
+    const u32 widths[] = {1, 2, 3, 4, 8, 12, 16, 24};
+    const u32 count = 200;
+    for (u32 w = 0; w < ARRAY_SIZE(widths); w++) {
+        const u32 width = widths[w];
+        list l = list_create(width * 4, width);
+        u8 element[24] = {0};
+        for (u32 i = 0; i < count; i++) {
+            // Only the last byte differs, so earlier bytes match everywhere
+            memset(element, 0xAA, width);
+            element[width - 1] = (u8)i;
+            list_add(&l, element);
+        }
+
+        for (u32 i = 0; i < count; i++) {
+            memset(element, 0xAA, width);
+            element[width - 1] = (u8)i;
+            if (list_find(l, element) != i) {
+                printf("FIND: width %d, couldn't find element %d!\n", width, i);
+                result = false;
+                break;
+            }
+        }
+
+        memset(element, 0xAA, width);
+        element[width - 1] = 250;
+        if (list_contains(l, element)) {
+            printf("CONTAINS: width %d, false positive!\n", width);
+            result = false;
+        }
+        list_destroy(&l);
+    }
+
+    // A value made of the end of one element and the start of the next should
+    // never match.
+    list l = list_create(256, sizeof(u16));
+    for (u32 i = 0; i < 100; i++) {
+        const u16 val = (i % 2) ? 0x0034 : 0x1200;
+        list_add(&l, &val);
+    }
+    const u16 straddle = 0x3412;
+    if (list_contains(l, &straddle)) {
+        printf("FIND: matched a value straddling two elements!\n");
+        result = false;
+    }
+    list_destroy(&l);
+
+    REPORT_RESULT(result);
+    return result;
+}
+
+typedef struct {
+    float x;
+    float y;
+    float z;
+}test_vec3;
+LIST_DEFINE(test_vec3)
+
+bool test_list_typed() {
+    bool result = true;
+
+    list_u32 l = list_u32_create(2);
+    for (u32 i = 0; i < 1000; i++) {
+        list_u32_add(&l, i * 2);
+    }
+    if (list_u32_count(l) != 1000 || l.base.end_idx != 1000) {
+        printf("ADD: end_idx not incremented correctly!\n");
+        result = false;
+    }
+    if (list_u32_get(l, 500) != 1000 || *(u32*)list_get_element(l.base, 500) != 1000) {
+        printf("GET: typed & generic access disagree!\n");
+        result = false;
+    }
+    if (list_u32_find(l, 998) != 499 || list_u32_contains(l, 999)) {
+        printf("FIND: wrong result!\n");
+        result = false;
+    }
+    list_u32_remove(&l, 0);
+    if (list_u32_get(l, 0) != 1998 || list_u32_count(l) != 999) {
+        printf("REMOVE: last element didn't fill the hole!\n");
+        result = false;
+    }
+    list_u32_destroy(&l);
+
+    // Non-power-of-2 struct, which takes the inline search
+    list_test_vec3 verts = list_test_vec3_create(4);
+    for (u32 i = 0; i < 100; i++) {
+        list_test_vec3_add(&verts, (test_vec3){ (float)i, 1.0f, 2.0f });
+    }
+    if (list_test_vec3_at(verts, 42)->x != 42.0f) {
+        printf("AT: wrong element!\n");
+        result = false;
+    }
+    if (list_test_vec3_find(verts, (test_vec3){ 77.0f, 1.0f, 2.0f }) != 77) {
+        printf("FIND: couldn't find struct element!\n");
+        result = false;
+    }
+
+    // Normal list functions should work on the typed list
+    list_add_many(&verts.base, verts.items, 10);
+    if (verts.items[105].x != 5.0f) {
+        printf("BASE: normal list functions don't work on the typed list!\n");
+        result = false;
+    }
+    list_test_vec3_clear(&verts);
+    if (!list_test_vec3_empty(verts)) {
+        printf("CLEAR: list isn't empty!\n");
+        result = false;
+    }
+    list_test_vec3_destroy(&verts);
+
+    REPORT_RESULT(result);
+    return result;
+}
+
+static bool is_odd(const void* element, void* ctx) {
+    u32* calls = ctx;
+    (*calls)++;
+    return (*(const u32*)element % 2) != 0;
+}
+
+// Check that a list holds exactly the expected values, in order
+static bool list_matches(list l, const u32* expected, u32 count) {
+    return l.end_idx == count && memcmp((void*)l.data, expected, count * sizeof(u32)) == 0;
+}
+
+bool test_list_remove() {
+    bool result = true;
+
+    list l = list_create(16, sizeof(u32));
+    for (u32 i = 0; i < 10; i++) {
+        list_add(&l, &i);
+    }
+
+    list_remove_ordered(&l, 0);
+    list_remove_ordered(&l, 8); // Last element
+    list_remove_ordered(&l, 100); // Out of bounds, should do nothing
+    const u32 after_ordered[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    if (!list_matches(l, after_ordered, ARRAY_SIZE(after_ordered))) {
+        printf("REMOVE_ORDERED: wrong result!\n");
+        result = false;
+    }
+
+    // Duplicate, and out of bounds indices should be skipped
+    const csize indices[] = {1, 1, 2, 5, 7, 50};
+    const csize removed = list_remove_indices(&l, indices, ARRAY_SIZE(indices));
+    const u32 after_indices[] = {1, 4, 5, 7};
+    if (removed != 4 || !list_matches(l, after_indices, ARRAY_SIZE(after_indices))) {
+        printf("REMOVE_INDICES: wrong result!\n");
+        result = false;
+    }
+
+    // Predicate removal on a bigger list, with runs of different lengths
+    list_clear(&l);
+    for (u32 i = 0; i < 1000; i++) {
+        const u32 val = (i % 7 == 0) ? i * 2 : i;
+        list_add(&l, &val);
+    }
+    u32 calls = 0;
+    const csize odd_removed = list_remove_if(&l, is_odd, &calls);
+    if (calls != 1000) {
+        printf("REMOVE_IF: predicate called %d times instead of once per element!\n", calls);
+        result = false;
+    }
+    csize expected_idx = 0;
+    for (u32 i = 0; i < 1000; i++) {
+        const u32 val = (i % 7 == 0) ? i * 2 : i;
+        if (val % 2 != 0) {
+            continue;
+        }
+        if (expected_idx >= l.end_idx || *(u32*)list_get_element(l, expected_idx) != val) {
+            printf("REMOVE_IF: kept elements are wrong or out of order!\n");
+            result = false;
+            break;
+        }
+        expected_idx++;
+    }
+    if (expected_idx != l.end_idx || odd_removed != 1000 - l.end_idx) {
+        printf("REMOVE_IF: wrong number of elements removed!\n");
+        result = false;
+    }
+
+    list_destroy(&l);
+    REPORT_RESULT(result);
+    return result;
+}
+
+bool test_list_map_file() {
+    bool result = true;
+    const char* path = "bobtail_test_list.bin";
+    remove(path); // In case a previous run crashed
+
+    list l = list_map_file(path, sizeof(u32));
+    if ((void*)l.data == NULL || l.file == NULL) {
+        printf("MAP: couldn't create list file!\n");
+        return false;
+    }
+    if (l.end_idx != 0) {
+        printf("MAP: new list isn't empty!\n");
+        result = false;
+    }
+
+    // Enough to extend the file a bunch of times
+    const u32 count = 10000;
+    for (u32 i = 0; i < count; i++) {
+        list_add(&l, &i);
+    }
+    if (!list_sync(&l)) {
+        printf("SYNC: failed!\n");
+        result = false;
+    }
+    list_destroy(&l);
+
+    // Reopening should give us everything back
+    l = list_map_file(path, sizeof(u32));
+    if ((void*)l.data == NULL || l.end_idx != count) {
+        printf("MAP: reopened list has the wrong count!\n");
+        result = false;
+    }
+    for (u32 i = 0; i < l.end_idx; i++) {
+        if (*(u32*)list_get_element(l, i) != i) {
+            printf("MAP: element %d is wrong after reopening!\n", i);
+            result = false;
+            break;
+        }
+    }
+    list_destroy(&l);
+
+    // Opening with the wrong element size should fail
+    l = list_map_file(path, sizeof(u64));
+    if ((void*)l.data != NULL) {
+        printf("MAP: opened a list file with the wrong element size!\n");
+        result = false;
+        list_destroy(&l);
+    }
+    remove(path);
+
+    // A file that isn't a list must be rejected without being touched
+    FILE* other = fopen(path, "wb");
+    if (other == NULL) {
+        printf("MAP: couldn't create a non-list file!\n");
+        return false;
+    }
+    fputs("not a list", other);
+    fclose(other);
+    l = list_map_file(path, sizeof(u32));
+    if ((void*)l.data != NULL) {
+        printf("MAP: opened a file that isn't a list!\n");
+        result = false;
+        list_destroy(&l);
+    }
+    if (file_size(path) != strlen("not a list")) {
+        printf("MAP: a rejected file was resized to 0x%X bytes!\n", file_size(path));
+        result = false;
+    }
+
+    remove(path);
+    REPORT_RESULT(result);
+    return result;
+}
+
+/// Records the size of the last realloc & fails it, so we can see what size
+/// a list asks for without actually allocating gigabytes
+static void* size_probe_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    (void)ptr;
+    (void)old_size;
+    *(u64*)ctx = new_size;
+    return NULL;
+}
+
+static void* size_probe_alloc(void* ctx, size_t size) {
+    (void)ctx;
+    return calloc(1, size);
+}
+
+static void size_probe_free(void* ctx, void* ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+bool test_list_grow_limit() {
+    bool result = true;
+
+    u64 requested = 0;
+    const allocator probe = {
+        .alloc = size_probe_alloc,
+        .realloc = size_probe_realloc,
+        .free = size_probe_free,
+        .ctx = &requested,
+    };
+    list l = list_create_alloc(16, sizeof(u32), &probe);
+    if ((void*)l.data == NULL) {
+        printf("CREATE: Initial alloc failed!\n");
+        return false;
+    }
+
+    // Pretend the list is full & so big that the growth factor's target
+    // (1.5x) doesn't fit in a 32-bit size. The size it actually needs does,
+    // so it has to ask for something between the two.
+    const csize real_size = l.alloc_size;
+    const csize fake_size = (csize)(0xC0000000 & ~(u64)(sizeof(u32) - 1));
+    l.alloc_size = fake_size;
+    l.end_idx = (fake_size / sizeof(u32)) - 1;
+    const u32 val = 0;
+    list_add(&l, &val); // The probe fails the realloc, so nothing is written
+    if (requested < (u64)fake_size + sizeof(u32) || requested > CSIZE_MAX || requested % sizeof(u32) != 0) {
+        printf("GROW: Asked for 0x%llX bytes to grow from 0x%llX!\n", (unsigned long long)requested, (unsigned long long)fake_size);
+        result = false;
+    }
+
+    l.alloc_size = real_size;
+    l.end_idx = 0;
+    list_destroy(&l);
     REPORT_RESULT(result);
     return result;
 }
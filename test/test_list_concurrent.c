@@ -0,0 +1,86 @@
+#include <stdlib.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/thread.h>
+#include <common/list_concurrent.h>
+
+#include "testing.h"
+
+enum {
+    PRODUCER_COUNT = 4,
+    PRODUCER_ADDS = 20000,
+};
+
+typedef struct {
+    list_concurrent* l;
+    u32 id;
+}producer_args;
+
+static void producer(void* arg) {
+    producer_args* args = arg;
+    for (u32 i = 0; i < PRODUCER_ADDS; i++) {
+        const u32 val = (args->id * PRODUCER_ADDS) + i;
+        list_concurrent_add(args->l, &val);
+    }
+}
+
+bool test_list_concurrent() {
+    bool result = true;
+
+    // Tiny first chunk, so we go through lots of chunk allocations
+    list_concurrent l = list_concurrent_create(4, sizeof(u32));
+    thread threads[PRODUCER_COUNT] = {0};
+    producer_args args[PRODUCER_COUNT] = {0};
+    for (u32 i = 0; i < PRODUCER_COUNT; i++) {
+        args[i] = (producer_args){ .l = &l, .id = i };
+        if (!thread_create(&threads[i], producer, &args[i])) {
+            printf("ADD: couldn't start producer thread!\n");
+            return false;
+        }
+    }
+
+    // Read while the producers are still going. The published prefix should
+    // only ever grow, and every element in it should be fully written.
+    csize last_count = 0;
+    while (last_count < PRODUCER_COUNT * PRODUCER_ADDS) {
+        const csize count = list_concurrent_count(&l);
+        if (count < last_count) {
+            printf("COUNT: published prefix shrank!\n");
+            result = false;
+            break;
+        }
+        if (count > 0 && *(u32*)list_concurrent_get_element(&l, count - 1) >= PRODUCER_COUNT * PRODUCER_ADDS) {
+            printf("GET: read an element that wasn't written yet!\n");
+            result = false;
+            break;
+        }
+        last_count = count;
+    }
+
+    for (u32 i = 0; i < PRODUCER_COUNT; i++) {
+        thread_join(threads[i]);
+    }
+
+    // Every value should show up exactly once
+    const csize total = PRODUCER_COUNT * PRODUCER_ADDS;
+    if (list_concurrent_count(&l) != total) {
+        printf("ADD: wrong number of elements published!\n");
+        result = false;
+    }
+    bool* seen = calloc(total, sizeof(bool));
+    for (csize i = 0; i < total && seen != NULL; i++) {
+        const u32 val = *(u32*)list_concurrent_get_element(&l, i);
+        if (val >= total || seen[val]) {
+            printf("ADD: value %d is invalid or duplicated!\n", val);
+            result = false;
+            break;
+        }
+        seen[val] = true;
+    }
+    free(seen);
+
+    list_concurrent_destroy(&l);
+    REPORT_RESULT(result);
+    return result;
+}
@@ -0,0 +1,93 @@
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/list_indexed.h>
+
+#include "testing.h"
+
+// Check that every element in the list can be found through the index
+static bool index_consistent(list_indexed l) {
+    for (csize i = 0; i < l.items.end_idx; i++) {
+        const u32 val = *(u32*)list_get_element(l.items, i);
+        const s64 found = list_indexed_find(l, &val);
+        if (found == -1 || *(u32*)list_get_element(l.items, found) != val) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_list_indexed() {
+    bool result = true;
+
+    list_indexed l = list_indexed_create(16, sizeof(u32));
+    if ((void*)l.items.data == NULL || l.slots == NULL) {
+        printf("CREATE: Initial alloc failed!\n");
+        return false;
+    }
+
+    // Enough to force the index to be rebuilt a bunch of times
+    const u32 count = 5000;
+    for (u32 i = 0; i < count; i++) {
+        const u32 val = i * 3;
+        list_indexed_add(&l, &val);
+    }
+    if (l.items.end_idx != count) {
+        printf("ADD: end_idx not incremented correctly!\n");
+        result = false;
+    }
+    if (l.slot_count < count) {
+        printf("ADD: index didn't grow!\n");
+        result = false;
+    }
+    for (u32 i = 0; i < count; i++) {
+        const u32 val = i * 3;
+        if (list_indexed_find(l, &val) != i) {
+            printf("FIND: got the wrong index for %d!\n", val);
+            result = false;
+            break;
+        }
+    }
+    const u32 missing = 1; // Not a multiple of 3
+    if (list_indexed_contains(l, &missing)) {
+        printf("CONTAINS: false positive!\n");
+        result = false;
+    }
+
+    // Remove every other value, which shuffles elements around a lot
+    for (u32 i = 0; i < count; i += 2) {
+        const u32 val = i * 3;
+        list_indexed_remove_val(&l, &val);
+        if (list_indexed_contains(l, &val)) {
+            printf("REMOVE: %d is still there!\n", val);
+            result = false;
+            break;
+        }
+    }
+    if (l.items.end_idx != count / 2) {
+        printf("REMOVE: end_idx not decremented correctly!\n");
+        result = false;
+    }
+    if (!index_consistent(l)) {
+        printf("REMOVE: index is out of sync with the list!\n");
+        result = false;
+    }
+
+    // Removing by index, including the last element
+    list_indexed_remove(&l, l.items.end_idx - 1);
+    list_indexed_remove(&l, 0);
+    if (!index_consistent(l)) {
+        printf("REMOVE: index is out of sync after removing by index!\n");
+        result = false;
+    }
+
+    list_indexed_clear(&l);
+    const u32 val = 3;
+    if (list_indexed_contains(l, &val) || l.items.end_idx != 0) {
+        printf("CLEAR: list wasn't emptied!\n");
+        result = false;
+    }
+
+    list_indexed_destroy(&l);
+    REPORT_RESULT(result);
+    return result;
+}
@@ -0,0 +1,118 @@
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/list.h>
+#include <common/list_sort.h>
+
+#include "testing.h"
+
+static int compare_u32(const void* a, const void* b) {
+    const u32 x = *(const u32*)a;
+    const u32 y = *(const u32*)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    u32 order;
+    u16 key;
+    u16 padding;
+}keyed;
+
+// Deterministic pseudo-random numbers, so failures are reproducible
+static u32 next_random(u32* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static bool sorted_u32(list l) {
+    for (csize i = 1; i < l.end_idx; i++) {
+        if (*(u32*)list_get_element(l, i - 1) > *(u32*)list_get_element(l, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_list_sort() {
+    bool result = true;
+    u32 state = 0xB0B7A11;
+
+    // Big enough to take the parallel path on machines with multiple cores
+    const u32 count = LIST_SORT_PARALLEL_MIN + 1000;
+    list l = list_create(16, sizeof(u32));
+    list_reserve(&l, count);
+    for (u32 i = 0; i < count; i++) {
+        const u32 val = next_random(&state);
+        list_add(&l, &val);
+    }
+    list copy = list_create(16, sizeof(u32));
+    list_merge(&copy, l);
+
+    list_sort(&l, compare_u32);
+    if (!sorted_u32(l) || l.end_idx != count) {
+        printf("SORT: list isn't sorted!\n");
+        result = false;
+    }
+
+    if (!list_radix_sort(&copy, 0, sizeof(u32)) || !sorted_u32(copy)) {
+        printf("RADIX: list isn't sorted!\n");
+        result = false;
+    }
+    if (memcmp((void*)l.data, (void*)copy.data, count * sizeof(u32)) != 0) {
+        printf("RADIX: result doesn't match comparison sort!\n");
+        result = false;
+    }
+
+    // Binary search for values that are & aren't there
+    const u32 present = *(u32*)list_get_element(l, count / 3);
+    const s64 found = list_bsearch(l, &present, compare_u32);
+    if (found == -1 || *(u32*)list_get_element(l, found) != present) {
+        printf("BSEARCH: couldn't find a value that's there!\n");
+        result = false;
+    }
+    const u32 smallest = *(u32*)list_get_element(l, 0);
+    if (smallest > 0) {
+        const u32 below = smallest - 1;
+        if (list_bsearch(l, &below, compare_u32) != -1 || list_lower_bound(l, &below, compare_u32) != 0) {
+            printf("BSEARCH: value below the whole list handled wrong!\n");
+            result = false;
+        }
+    }
+    const u32 biggest = UINT32_MAX;
+    if (*(u32*)list_get_element(l, count - 1) != biggest && list_lower_bound(l, &biggest, compare_u32) != count) {
+        printf("LOWER_BOUND: value above the whole list handled wrong!\n");
+        result = false;
+    }
+    list_destroy(&copy);
+    list_destroy(&l);
+
+    // Radix sort on a key inside a struct has to be stable
+    list structs = list_create(16, sizeof(keyed));
+    for (u32 i = 0; i < 10000; i++) {
+        const keyed k = { .order = i, .key = next_random(&state) % 50 };
+        list_add(&structs, &k);
+    }
+    list_radix_sort(&structs, offsetof(keyed, key), sizeof(u16));
+    for (csize i = 1; i < structs.end_idx; i++) {
+        const keyed* a = list_get_element(structs, i - 1);
+        const keyed* b = list_get_element(structs, i);
+        if (a->key > b->key || (a->key == b->key && a->order > b->order)) {
+            printf("RADIX: struct keys out of order, or sort isn't stable!\n");
+            result = false;
+            break;
+        }
+    }
+    if (list_radix_sort(&structs, 6, sizeof(u32))) {
+        printf("RADIX: accepted a key hanging off the end of the element!\n");
+        result = false;
+    }
+    list_destroy(&structs);
+
+    REPORT_RESULT(result);
+    return result;
+}
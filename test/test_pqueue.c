@@ -0,0 +1,110 @@
+#include <stdlib.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/pqueue.h>
+
+#include "testing.h"
+
+/// Small xorshift generator, so the test is the same on every platform
+static u64 pqueue_rand(u64* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+bool test_pqueue() {
+    bool result = true;
+
+    pqueue q = pqueue_create(4, sizeof(u32));
+    if (!pqueue_empty(q) || pqueue_peek(q, NULL) != PQUEUE_INVALID || pqueue_pop(&q, NULL, NULL)) {
+        printf("CREATE: New queue isn't empty!\n");
+        result = false;
+    }
+
+    // Random keys have to come out sorted, with their data attached
+    u64 seed = 0x9E3779B97F4A7C15;
+    for (u32 i = 0; i < 1000; i++) {
+        const u32 val = (u32)pqueue_rand(&seed) % 500;
+        pqueue_push(&q, val, &val);
+    }
+    u64 last_key = 0;
+    for (u32 i = 0; i < 1000; i++) {
+        u64 key = 0;
+        u32 val = 0;
+        if (!pqueue_pop(&q, &key, &val) || key < last_key || val != key) {
+            printf("POP: Keys came out of order, or data didn't match its key!\n");
+            result = false;
+            break;
+        }
+        last_key = key;
+    }
+    if (!pqueue_empty(q)) {
+        printf("POP: Queue isn't empty after popping everything!\n");
+        result = false;
+    }
+
+    // Decrease-key moves an element to the front
+    u32 data = 0;
+    csize handles[10] = {0};
+    for (u32 i = 0; i < ARRAY_SIZE(handles); i++) {
+        data = i;
+        handles[i] = pqueue_push(&q, 100 + i, &data);
+    }
+    if (!pqueue_decrease_key(&q, handles[7], 5)) {
+        printf("DECREASE: Couldn't decrease a key!\n");
+        result = false;
+    }
+    if (pqueue_decrease_key(&q, handles[3], 500)) {
+        printf("DECREASE: Allowed a key to go up!\n");
+        result = false;
+    }
+    u64 key = 0;
+    if (pqueue_peek(q, &key) != handles[7] || key != 5 || *(u32*)pqueue_get_element(q, handles[7]) != 7) {
+        printf("DECREASE: Element didn't move to the front!\n");
+        result = false;
+    }
+    pqueue_pop(&q, NULL, &data);
+    if (pqueue_contains(q, handles[7]) || pqueue_decrease_key(&q, handles[7], 0) || pqueue_get_element(q, handles[7]) != NULL) {
+        printf("POP: Popped handle still looks valid!\n");
+        result = false;
+    }
+    // Popped handles get reused
+    data = 77;
+    if (pqueue_push(&q, 0, &data) != handles[7]) {
+        printf("PUSH: Didn't reuse a popped handle!\n");
+        result = false;
+    }
+
+    // Heapify from arrays, with no element data
+    pqueue keys_only = pqueue_create(0, 0);
+    u64 keys[333] = {0};
+    for (u32 i = 0; i < ARRAY_SIZE(keys); i++) {
+        keys[i] = pqueue_rand(&seed);
+    }
+    if (!pqueue_heapify(&keys_only, keys, NULL, ARRAY_SIZE(keys))) {
+        printf("HEAPIFY: Failed!\n");
+        result = false;
+    }
+    if (pqueue_count(keys_only) != ARRAY_SIZE(keys) || !pqueue_contains(keys_only, 0) || !pqueue_contains(keys_only, 332)) {
+        printf("HEAPIFY: Wrong count or handles!\n");
+        result = false;
+    }
+    last_key = 0;
+    while (!pqueue_empty(keys_only)) {
+        const csize handle = pqueue_peek(keys_only, &key);
+        if (key < last_key || keys[handle] != key) {
+            printf("HEAPIFY: Keys came out of order, or handles don't match the input!\n");
+            result = false;
+            break;
+        }
+        last_key = key;
+        pqueue_pop(&keys_only, NULL, NULL);
+    }
+
+    pqueue_destroy(&keys_only);
+    pqueue_destroy(&q);
+    REPORT_RESULT(result);
+    return result;
+}
@@ -10,98 +10,178 @@ bool test_queue() {
     bool result = true;
 
     // Test basic queue creation
-    const u32 alloc_size = 2;
     queue empty = {0}; // For testing reaction to empty queue
-    queue q = queue_create(alloc_size);
-    if (q.data == NULL) {
+    queue q = queue_create(3 * sizeof(u64), sizeof(u64));
+    if ((void*)q.data == NULL) {
         printf("CREATE: Initial alloc failed!\n");
         result = false;
     }
-    if (q.alloc_size != alloc_size) {
-        printf("CREATE: Initial alloc has the wrong size!\n");
+    if (q.capacity != 4) {
+        printf("CREATE: Capacity wasn't rounded up to a power of 2!\n");
         result = false;
     }
-    if (q.front_idx != 0) {
-        printf("CREATE: Front index didn't start at 0!\n");
-        result = false;
-    }
-    if (q.back_idx != 0) {
-        printf("CREATE: Back index didn't start at 0!\n");
-        result = false;
-    }
-    if (q.front_idx != q.back_idx) {
-        printf("CREATE: Front & back index don't match!\n");
+    if (q.head != 0 || q.tail != 0 || !queue_empty(q)) {
+        printf("CREATE: Queue didn't start out empty!\n");
         result = false;
     }
 
     // Retreiving from an empty queue should fail
-    const queue_element element = queue_get(&q);
-    if (element != 0) {
+    u64 element = 42;
+    if (queue_get(&q, &element) || element != 42 || queue_peek(q) != NULL) {
         printf("GET: Queue allowed out-of-bounds read on empty queue!\n");
         result = false;
     }
 
-    const queue_element temp = 42;
-    queue_add(&q, temp);
-    if (q.alloc_size < sizeof(queue_element) && q.data != NULL) {
-        printf("ADD: Resizing doesn't ensure enough space for an element!\n");
+    const u64 temp = 42;
+    queue_add(&q, &temp);
+    if (queue_count(q) != 1) {
+        printf("ADD: Count didn't go up!\n");
         result = false;
     }
-    if (q.back_idx != 1) {
-        printf("ADD: Back index didn't move!\n");
-        result = false;
-    }
-    if (q.data[0] != temp) {
+    if (queue_peek(q) == NULL || *(u64*)queue_peek(q) != temp) {
         printf("ADD: Failed to add element or added the wrong data!\n");
         result = false;
     }
-    queue_add(&q, temp);
+    queue_add(&q, &temp);
 
-    if (queue_get(&q) != temp) {
+    element = 0;
+    if (!queue_get(&q, &element) || element != temp) {
         printf("GET: Failed to read element that should exist!\n");
         result = false;
     }
-    if (q.front_idx == 0) {
-        printf("GET: Didn't move front idx correctly!\n");
+    if (queue_count(q) != 1) {
+        printf("GET: Count didn't go down!\n");
         result = false;
     }
-    if (q.back_idx == 0) {
-        printf("GET: Reset indices at the wrong time!\n");
+    queue_get(&q, NULL);
+    if (!queue_empty(q)) {
+        printf("GET: Queue isn't empty after getting the last element!\n");
         result = false;
     }
 
-    // After getting the last element in the queue, it should reset
-    queue_get(&q);
-    if (q.back_idx != 0 || q.front_idx != 0) {
-        printf("GET: Indices weren't reset on empty queue!\n");
+    // Wrap around the end of the buffer many times, the buffer should never
+    // grow since there's never more than 3 elements at once.
+    u64 next_in = 0;
+    u64 next_out = 0;
+    for (u32 i = 0; i < 100; i++) {
+        queue_add(&q, &next_in);
+        next_in++;
+        if (queue_count(q) == 3) {
+            queue_get(&q, &element);
+            if (element != next_out++) {
+                printf("WRAP: Got elements out of order!\n");
+                result = false;
+                break;
+            }
+        }
+    }
+    if (q.capacity != 4) {
+        printf("WRAP: Queue grew when it wasn't full!\n");
         result = false;
     }
 
+    // Growing while wrapped around has to keep everything in order. Try it
+    // from every possible head position.
+    for (u32 offset = 0; offset < 8; offset++) {
+        queue g = queue_create(8 * sizeof(u64), sizeof(u64));
+        for (u64 i = 0; i < offset; i++) {
+            queue_add(&g, &i);
+            queue_get(&g, NULL);
+        }
+        for (u64 i = 0; i < 20; i++) {
+            queue_add(&g, &i);
+        }
+        for (u64 i = 0; i < 20; i++) {
+            if (!queue_get(&g, &element) || element != i) {
+                printf("GROW: Lost element order after growing from head position %u!\n", offset);
+                result = false;
+                break;
+            }
+        }
+        queue_destroy(&g);
+    }
+
+    // Batches, including ones that wrap around the end of the buffer & ones
+    // that need to grow a wrapped buffer by more than double
+    queue b = queue_create(8 * sizeof(u64), sizeof(u64));
+    u64 batch[40] = {0};
+    for (u64 i = 0; i < ARRAY_SIZE(batch); i++) {
+        batch[i] = i;
+    }
+    queue_add_many(&b, batch, 6);
+    if (queue_get_many(&b, batch, 4) != 4 || batch[3] != 3) {
+        printf("BATCH: Batch get returned the wrong elements!\n");
+        result = false;
+    }
+    const u64 wrap_in[5] = { 6, 7, 8, 9, 10 };
+    queue_add_many(&b, wrap_in, ARRAY_SIZE(wrap_in));
+    if (b.capacity != 8 || queue_count(b) != 7) {
+        printf("BATCH: Wrapping batch add grew the queue for no reason!\n");
+        result = false;
+    }
+    for (u64 i = 0; i < ARRAY_SIZE(batch); i++) {
+        batch[i] = i + 11;
+    }
+    queue_add_many(&b, batch, 30);
+    if (b.capacity != 64 || queue_count(b) != 37) {
+        printf("BATCH: Batch add didn't grow to fit in one step!\n");
+        result = false;
+    }
+    u64 out[64] = {0};
+    const csize got = queue_get_many(&b, out, ARRAY_SIZE(out));
+    if (got != 37 || !queue_empty(b)) {
+        printf("BATCH: Batch get didn't drain the queue!\n");
+        result = false;
+    }
+    for (u64 i = 0; i < got; i++) {
+        if (out[i] != i + 4) {
+            printf("BATCH: Elements out of order after batches!\n");
+            result = false;
+            break;
+        }
+    }
+    if (queue_get_many(&b, out, ARRAY_SIZE(out)) != 0) {
+        printf("BATCH: Batch get from an empty queue!\n");
+        result = false;
+    }
+    // An empty batch is a no-op, even with no data or no buffer yet
+    queue_add_many(&b, NULL, 0);
+    queue nobuf = {0};
+    queue_add_many(&nobuf, NULL, 0);
+    if (!queue_empty(b) || nobuf.data != 0) {
+        printf("BATCH: Empty batch add changed the queue!\n");
+        result = false;
+    }
+    queue_destroy(&b);
+
     if (!queue_empty(empty)) {
         printf("EMPTY: False negative!\n");
         result = false;
     }
 
-    // This will just crash if NULL isn't handled
-    queue_add(&empty, 42);
-
-    // We have to clear it again in case NULL is handled correctly
-    free(empty.data);
-    empty = (queue){0};
-    queue_get(&empty);
+    // This will just crash if no element size is handled
+    queue_add(&empty, &temp);
+    empty.element_size = sizeof(u64);
+    queue_add(&empty, &temp);
+    if (!queue_get(&empty, &element) || element != temp) {
+        printf("ADD: Zero-initialized queue didn't grow!\n");
+        result = false;
+    }
+    queue_destroy(&empty);
 
     // Add some elements back to test clearing
-    queue_add(&q, temp);
-    queue_add(&q, temp);
+    queue_add(&q, &temp);
+    queue_add(&q, &temp);
     if (queue_empty(q)) {
         printf("EMPTY: False positive!\n");
         result = false;
     }
     queue_clear(&q);
-    if (q.front_idx != 0 || q.back_idx != 0 || q.data == NULL || q.alloc_size == 0) {
+    if (!queue_empty(q) || (void*)q.data == NULL || q.capacity == 0) {
         printf("CLEAR: Clear doesn't act as expected!\n");
         result = false;
     }
+    queue_destroy(&q);
 
     REPORT_RESULT(result);
     return result;
@@ -0,0 +1,160 @@
+#include <stdlib.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/thread.h>
+#include <common/queue_blocking.h>
+
+#include "testing.h"
+
+enum {
+    BLOCKING_PRODUCERS = 2,
+    BLOCKING_CONSUMERS = 3,
+    BLOCKING_PUSHES = 20000,
+    BLOCKING_TIMEOUT_MS = 20,
+};
+
+typedef struct {
+    queue_blocking* q;
+    u32 id;
+    bool* seen;
+    _Atomic(u32)* bad;
+}blocking_args;
+
+static void blocking_producer(void* arg) {
+    blocking_args* args = arg;
+    for (u32 i = 0; i < BLOCKING_PUSHES; i++) {
+        const u32 val = (args->id * BLOCKING_PUSHES) + i;
+        if (!queue_blocking_push(args->q, &val)) {
+            atomic_fetch_add(args->bad, 1);
+        }
+        // Let the consumers run dry & fall asleep every so often
+        if (i % 1000 == 0) {
+            thread_yield();
+        }
+    }
+}
+
+static void blocking_consumer(void* arg) {
+    blocking_args* args = arg;
+    u32 val = 0;
+    while (queue_blocking_pop(args->q, &val, THREAD_WAIT_FOREVER) == QUEUE_WAIT_OK) {
+        if (val >= BLOCKING_PRODUCERS * BLOCKING_PUSHES || args->seen[val]) {
+            atomic_fetch_add(args->bad, 1);
+            continue;
+        }
+        args->seen[val] = true;
+    }
+}
+
+bool test_queue_blocking() {
+    bool result = true;
+
+    // The futex wrapper shouldn't sleep when the value already changed
+    _Atomic(u32) word = 1;
+    if (!thread_wait(&word, 0, THREAD_WAIT_FOREVER)) {
+        printf("WAIT: Waiting on a changed value didn't return right away!\n");
+        result = false;
+    }
+
+    queue_blocking q = {0};
+    if (!queue_blocking_init(&q, 4 * sizeof(u32), sizeof(u32))) {
+        printf("INIT: Couldn't create a queue!\n");
+        return false;
+    }
+    u32 val = 42;
+    if (queue_blocking_try_pop(&q, &val) || val != 42) {
+        printf("POP: Popped from an empty queue!\n");
+        result = false;
+    }
+    if (queue_blocking_pop(&q, &val, 0) != QUEUE_WAIT_TIMEOUT) {
+        printf("POP: Zero timeout didn't time out on an empty queue!\n");
+        result = false;
+    }
+    const u64 start = thread_time_ms();
+    if (queue_blocking_pop(&q, &val, BLOCKING_TIMEOUT_MS) != QUEUE_WAIT_TIMEOUT) {
+        printf("POP: Didn't time out on an empty queue!\n");
+        result = false;
+    }
+    // Clocks can be coarse, so allow a little slack
+    if (thread_time_ms() - start < BLOCKING_TIMEOUT_MS - 2) {
+        printf("POP: Timed out too early!\n");
+        result = false;
+    }
+
+    for (u32 i = 0; i < 10; i++) {
+        queue_blocking_push(&q, &i);
+    }
+    if (queue_blocking_count(&q) != 10) {
+        printf("PUSH: Wrong count!\n");
+        result = false;
+    }
+    for (u32 i = 0; i < 10; i++) {
+        if (queue_blocking_pop(&q, &val, THREAD_WAIT_FOREVER) != QUEUE_WAIT_OK || val != i) {
+            printf("POP: Elements out of order!\n");
+            result = false;
+            break;
+        }
+    }
+
+    // Closing lets consumers drain what's left, then stops them
+    queue_blocking_push(&q, &val);
+    queue_blocking_close(&q);
+    if (queue_blocking_push(&q, &val)) {
+        printf("CLOSE: Pushed to a closed queue!\n");
+        result = false;
+    }
+    if (queue_blocking_pop(&q, &val, THREAD_WAIT_FOREVER) != QUEUE_WAIT_OK) {
+        printf("CLOSE: Couldn't drain a closed queue!\n");
+        result = false;
+    }
+    if (queue_blocking_pop(&q, &val, THREAD_WAIT_FOREVER) != QUEUE_WAIT_CLOSED) {
+        printf("CLOSE: Waited on a closed & empty queue!\n");
+        result = false;
+    }
+    queue_blocking_destroy(&q);
+
+    // Consumers that sleep while producers trickle elements in. Every value
+    // has to come out exactly once, and closing has to wake everyone up.
+    if (!queue_blocking_init(&q, 16 * sizeof(u32), sizeof(u32))) {
+        printf("INIT: Couldn't create a queue!\n");
+        return false;
+    }
+    const u32 total = BLOCKING_PRODUCERS * BLOCKING_PUSHES;
+    bool* seen = calloc(total, sizeof(bool));
+    _Atomic(u32) bad = 0;
+    thread threads[BLOCKING_PRODUCERS + BLOCKING_CONSUMERS] = {0};
+    blocking_args args[BLOCKING_PRODUCERS + BLOCKING_CONSUMERS] = {0};
+    for (u32 i = 0; i < ARRAY_SIZE(threads); i++) {
+        args[i] = (blocking_args){ .q = &q, .id = i, .seen = seen, .bad = &bad };
+        const thread_proc proc = (i < BLOCKING_PRODUCERS) ? blocking_producer : blocking_consumer;
+        if (!thread_create(&threads[i], proc, &args[i])) {
+            printf("THREAD: Couldn't start thread!\n");
+            return false;
+        }
+    }
+    for (u32 i = 0; i < BLOCKING_PRODUCERS; i++) {
+        thread_join(threads[i]);
+    }
+    queue_blocking_close(&q);
+    for (u32 i = BLOCKING_PRODUCERS; i < ARRAY_SIZE(threads); i++) {
+        thread_join(threads[i]);
+    }
+
+    if (atomic_load(&bad) != 0) {
+        printf("THREAD: %u elements were duplicated, invalid, or failed to push!\n", atomic_load(&bad));
+        result = false;
+    }
+    for (u32 i = 0; i < total; i++) {
+        if (!seen[i]) {
+            printf("THREAD: Value %u was lost!\n", i);
+            result = false;
+            break;
+        }
+    }
+    free(seen);
+    queue_blocking_destroy(&q);
+
+    REPORT_RESULT(result);
+    return result;
+}
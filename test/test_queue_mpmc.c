@@ -0,0 +1,133 @@
+#include <stdlib.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/thread.h>
+#include <common/queue_mpmc.h>
+
+#include "testing.h"
+
+enum {
+    MPMC_PRODUCERS = 4,
+    MPMC_CONSUMERS = 4,
+    MPMC_PUSHES = 50000,
+};
+
+/// An element bigger than a pointer, so torn copies would show up
+typedef struct {
+    u32 val;
+    u32 check;
+    u64 pad;
+}mpmc_item;
+
+typedef struct {
+    queue_mpmc* q;
+    u32 id;
+    bool* seen;
+    _Atomic(u32)* bad;
+}mpmc_args;
+
+static void mpmc_producer(void* arg) {
+    mpmc_args* args = arg;
+    for (u32 i = 0; i < MPMC_PUSHES; i++) {
+        const u32 val = (args->id * MPMC_PUSHES) + i;
+        const mpmc_item item = { .val = val, .check = ~val };
+        queue_mpmc_push(args->q, &item);
+    }
+}
+
+static void mpmc_consumer(void* arg) {
+    mpmc_args* args = arg;
+    // Producers & consumers are split evenly, so each consumer gets the same
+    // number of elements.
+    for (u32 i = 0; i < MPMC_PUSHES * MPMC_PRODUCERS / MPMC_CONSUMERS; i++) {
+        mpmc_item item = {0};
+        queue_mpmc_pop(args->q, &item);
+        if (item.check != ~item.val || item.val >= MPMC_PRODUCERS * MPMC_PUSHES) {
+            atomic_fetch_add(args->bad, 1);
+            continue;
+        }
+        // Each value goes to exactly 1 consumer, so no 2 threads ever write
+        // the same flag (unless something's broken)
+        args->seen[item.val] = true;
+    }
+}
+
+bool test_queue_mpmc() {
+    bool result = true;
+
+    queue_mpmc q = queue_mpmc_create(3, sizeof(mpmc_item));
+    if (q.cells == NULL || q.capacity != 4) {
+        printf("CREATE: Capacity wasn't rounded up to a power of 2!\n");
+        result = false;
+    }
+    mpmc_item item = {0};
+    if (queue_mpmc_try_pop(&q, &item)) {
+        printf("POP: Popped from an empty queue!\n");
+        result = false;
+    }
+    for (u32 i = 0; i < 4; i++) {
+        item.val = i;
+        if (!queue_mpmc_try_push(&q, &item)) {
+            printf("PUSH: Queue filled up early!\n");
+            result = false;
+        }
+    }
+    if (queue_mpmc_try_push(&q, &item) || queue_mpmc_count(&q) != 4) {
+        printf("PUSH: Pushed past the capacity!\n");
+        result = false;
+    }
+    // Go around the ring a few times
+    for (u32 i = 0; i < 10; i++) {
+        queue_mpmc_try_pop(&q, &item);
+        if (item.val != i) {
+            printf("POP: Elements out of order!\n");
+            result = false;
+            break;
+        }
+        item.val = i + 4;
+        queue_mpmc_try_push(&q, &item);
+    }
+    queue_mpmc_destroy(&q);
+
+    // Lots of threads on both ends of a small queue. Every value has to come
+    // out exactly once, and never torn.
+    q = queue_mpmc_create(16, sizeof(mpmc_item));
+    const u32 total = MPMC_PRODUCERS * MPMC_PUSHES;
+    bool* seen = calloc(total, sizeof(bool));
+    _Atomic(u32) bad = 0;
+    thread threads[MPMC_PRODUCERS + MPMC_CONSUMERS] = {0};
+    mpmc_args args[MPMC_PRODUCERS + MPMC_CONSUMERS] = {0};
+    for (u32 i = 0; i < ARRAY_SIZE(threads); i++) {
+        args[i] = (mpmc_args){ .q = &q, .id = i, .seen = seen, .bad = &bad };
+        const thread_proc proc = (i < MPMC_PRODUCERS) ? mpmc_producer : mpmc_consumer;
+        if (!thread_create(&threads[i], proc, &args[i])) {
+            printf("THREAD: Couldn't start thread!\n");
+            return false;
+        }
+    }
+    for (u32 i = 0; i < ARRAY_SIZE(threads); i++) {
+        thread_join(threads[i]);
+    }
+
+    if (atomic_load(&bad) != 0) {
+        printf("THREAD: %u elements were torn or invalid!\n", atomic_load(&bad));
+        result = false;
+    }
+    for (u32 i = 0; i < total; i++) {
+        if (!seen[i]) {
+            printf("THREAD: Value %u was lost!\n", i);
+            result = false;
+            break;
+        }
+    }
+    if (queue_mpmc_count(&q) != 0) {
+        printf("COUNT: Queue isn't empty after draining!\n");
+        result = false;
+    }
+    free(seen);
+    queue_mpmc_destroy(&q);
+
+    REPORT_RESULT(result);
+    return result;
+}
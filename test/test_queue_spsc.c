@@ -0,0 +1,115 @@
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/thread.h>
+#include <common/queue_spsc.h>
+
+#include "testing.h"
+
+enum {
+    TRANSFER_COUNT = 1000000,
+};
+
+static void spsc_producer(void* arg) {
+    queue_spsc* q = arg;
+    u32 batch[7] = {0};
+    u32 next = 0;
+    while (next < TRANSFER_COUNT) {
+        // Mix single & batch pushes, so both paths race with the consumer
+        if (next % 3 == 0) {
+            if (!queue_spsc_push(q, &next)) {
+                thread_yield();
+                continue;
+            }
+            next++;
+            continue;
+        }
+        const u32 n = MIN(ARRAY_SIZE(batch), TRANSFER_COUNT - next);
+        for (u32 i = 0; i < n; i++) {
+            batch[i] = next + i;
+        }
+        const csize pushed = queue_spsc_push_many(q, batch, n);
+        if (pushed == 0) {
+            thread_yield();
+        }
+        next += pushed;
+    }
+}
+
+bool test_queue_spsc() {
+    bool result = true;
+
+    queue_spsc q = queue_spsc_create(5, sizeof(u32));
+    if (q.data == NULL || q.capacity != 8) {
+        printf("CREATE: Capacity wasn't rounded up to a power of 2!\n");
+        result = false;
+    }
+
+    u32 val = 0;
+    if (queue_spsc_pop(&q, &val)) {
+        printf("POP: Popped from an empty queue!\n");
+        result = false;
+    }
+    for (u32 i = 0; i < 8; i++) {
+        if (!queue_spsc_push(&q, &i)) {
+            printf("PUSH: Queue filled up early!\n");
+            result = false;
+        }
+    }
+    if (queue_spsc_push(&q, &val) || queue_spsc_count(&q) != 8) {
+        printf("PUSH: Pushed past the capacity!\n");
+        result = false;
+    }
+
+    // Batches that wrap around the end of the ring
+    u32 out[8] = {0};
+    queue_spsc_pop_many(&q, out, 5);
+    const u32 in[6] = { 8, 9, 10, 11, 12, 13 };
+    if (queue_spsc_push_many(&q, in, ARRAY_SIZE(in)) != 5) {
+        printf("PUSH: Batch push didn't stop when full!\n");
+        result = false;
+    }
+    if (queue_spsc_pop_many(&q, out, ARRAY_SIZE(out)) != 8) {
+        printf("POP: Batch pop got the wrong count!\n");
+        result = false;
+    }
+    for (u32 i = 0; i < 8; i++) {
+        if (out[i] != i + 5) {
+            printf("POP: Batch elements out of order!\n");
+            result = false;
+            break;
+        }
+    }
+    queue_spsc_destroy(&q);
+
+    // Stream a lot of values through a tiny queue from another thread. They
+    // have to come out in the exact same order.
+    q = queue_spsc_create(64, sizeof(u32));
+    thread producer = {0};
+    if (!thread_create(&producer, spsc_producer, &q)) {
+        printf("THREAD: Couldn't start producer thread!\n");
+        return false;
+    }
+    u32 expected = 0;
+    while (expected < TRANSFER_COUNT) {
+        u32 batch[5] = {0};
+        const csize n = (expected % 2) ? queue_spsc_pop_many(&q, batch, ARRAY_SIZE(batch)) : queue_spsc_pop(&q, batch);
+        if (n == 0) {
+            thread_yield();
+            continue;
+        }
+        for (csize i = 0; i < n; i++) {
+            if (batch[i] != expected && result) {
+                // Keep draining, or the producer could get stuck on a full
+                // queue forever
+                printf("THREAD: Expected %u, got %u!\n", expected, batch[i]);
+                result = false;
+            }
+            expected = batch[i] + 1;
+        }
+    }
+    thread_join(producer);
+    queue_spsc_destroy(&q);
+
+    REPORT_RESULT(result);
+    return result;
+}
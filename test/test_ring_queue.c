@@ -0,0 +1,98 @@
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/vmem.h>
+#include <common/ring_queue.h>
+
+#include "testing.h"
+
+/// An odd element size, so elements straddle the end of the ring
+typedef struct {
+    u32 a;
+    u32 b;
+    u32 c;
+}sample;
+
+bool test_ring_queue() {
+    bool result = true;
+
+    ring_queue q = ring_queue_create(1, sizeof(sample));
+    if (q.data == NULL) {
+        printf("CREATE: Couldn't create ring queue!\n");
+        REPORT_RESULT(false);
+        return false;
+    }
+    if (q.ring_size != vmem_repeat_granularity() || q.capacity != vmem_repeat_granularity() / sizeof(sample)) {
+        printf("CREATE: Ring size wasn't rounded up to the allocation granularity!\n");
+        result = false;
+    }
+
+    sample s = {0};
+    if (ring_queue_get(&q, &s) || !ring_queue_empty(q)) {
+        printf("GET: Got an element from an empty ring!\n");
+        result = false;
+    }
+
+    // Fill it up completely
+    for (u32 i = 0; i < q.capacity; i++) {
+        s = (sample){ i, i * 2, i * 3 };
+        if (!ring_queue_add(&q, &s)) {
+            printf("ADD: Ring filled up early at element %u!\n", i);
+            result = false;
+            break;
+        }
+    }
+    if (ring_queue_add(&q, &s)) {
+        printf("ADD: Added past the capacity!\n");
+        result = false;
+    }
+
+    // Drain most of it, then push the back past the end of the ring
+    const csize drained = q.capacity - 10;
+    ring_queue_consume(&q, drained);
+    sample batch[100] = {0};
+    for (u32 i = 0; i < ARRAY_SIZE(batch); i++) {
+        const u32 val = q.capacity + i;
+        batch[i] = (sample){ val, val * 2, val * 3 };
+    }
+    if (!ring_queue_add_many(&q, batch, ARRAY_SIZE(batch))) {
+        printf("ADD: Couldn't add a batch across the end of the ring!\n");
+        result = false;
+    }
+
+    // The whole thing should be readable as one plain array, even though it
+    // wraps around.
+    csize count = 0;
+    const sample* span = ring_queue_peek_span(q, &count);
+    if (count != 10 + ARRAY_SIZE(batch)) {
+        printf("PEEK: Span has the wrong count (0x%llX)!\n", (unsigned long long)count);
+        result = false;
+    }
+    for (csize i = 0; i < count; i++) {
+        const u32 expected = drained + i;
+        if (span[i].a != expected || span[i].b != expected * 2 || span[i].c != expected * 3) {
+            printf("PEEK: Span element 0x%llX is wrong!\n", (unsigned long long)i);
+            result = false;
+            break;
+        }
+    }
+
+    sample out[200] = {0};
+    const csize got = ring_queue_get_many(&q, out, ARRAY_SIZE(out));
+    if (got != count || out[got - 1].a != q.capacity + ARRAY_SIZE(batch) - 1 || !ring_queue_empty(q)) {
+        printf("GET: Batch get didn't return everything!\n");
+        result = false;
+    }
+    if (q.head >= q.ring_size) {
+        printf("GET: Head wasn't wrapped back into the ring!\n");
+        result = false;
+    }
+
+    ring_queue_destroy(&q);
+    if (q.data != NULL) {
+        printf("DESTROY: Didn't clear the queue!\n");
+        result = false;
+    }
+
+    REPORT_RESULT(result);
+    return result;
+}
@@ -0,0 +1,88 @@
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/seglist.h>
+
+#include "testing.h"
+
+bool test_seglist() {
+    bool result = true;
+
+    // Non power of 2 chunk size should get rounded up
+    seglist l = seglist_create(100, sizeof(u32));
+    if (l.chunk_shift != 7) {
+        printf("CREATE: chunk size wasn't rounded up to a power of 2!\n");
+        result = false;
+    }
+    if (!seglist_empty(l)) {
+        printf("EMPTY: new list isn't empty!\n");
+        result = false;
+    }
+
+    // Pointers to elements have to survive the list growing
+    const u32 first = 0xB0B7A11;
+    const u32* first_ptr = seglist_add(&l, &first);
+    if (first_ptr == NULL || *first_ptr != first) {
+        printf("ADD: didn't return a pointer to the new element!\n");
+        result = false;
+    }
+
+    const u32 count = 1000;
+    for (u32 i = 1; i < count; i++) {
+        seglist_add(&l, &i);
+    }
+    if (l.end_idx != count) {
+        printf("ADD: end_idx not incremented correctly!\n");
+        result = false;
+    }
+    if (l.chunks.end_idx != 8) {
+        printf("ADD: wrong number of chunks allocated!\n");
+        result = false;
+    }
+    if (seglist_get_element(l, 0) != first_ptr || *first_ptr != first) {
+        printf("ADD: element moved during growth!\n");
+        result = false;
+    }
+    for (u32 i = 1; i < count; i++) {
+        if (*(u32*)seglist_get_element(l, i) != i) {
+            printf("GET: element %d is wrong!\n", i);
+            result = false;
+            break;
+        }
+    }
+
+    // Search across chunk boundaries
+    const u32 in_last_chunk = 999;
+    if (seglist_find(l, &in_last_chunk) != 999) {
+        printf("FIND: couldn't find value in the last chunk!\n");
+        result = false;
+    }
+    const u32 missing = count + 1;
+    if (seglist_contains(l, &missing)) {
+        printf("CONTAINS: false positive!\n");
+        result = false;
+    }
+
+    // Removal moves the last element into the hole
+    const u32 removed = 500;
+    seglist_remove_val(&l, &removed);
+    if (seglist_contains(l, &removed) || l.end_idx != count - 1) {
+        printf("REMOVE: value wasn't removed!\n");
+        result = false;
+    }
+    if (*(u32*)seglist_get_element(l, 500) != count - 1) {
+        printf("REMOVE: last element didn't fill the hole!\n");
+        result = false;
+    }
+
+    // Clearing keeps chunks around for re-use
+    seglist_clear(&l);
+    seglist_add(&l, &first);
+    if (l.chunks.end_idx != 8 || seglist_get_element(l, 0) != first_ptr) {
+        printf("CLEAR: chunks weren't re-used!\n");
+        result = false;
+    }
+
+    seglist_destroy(&l);
+    REPORT_RESULT(result);
+    return result;
+}
@@ -1,10 +1,37 @@
 #include <common/logging.h>
 #include <common/int.h>
 #include <common/vmem.h>
+#include <common/thread.h>
 #include <string.h>
 
 #include "testing.h"
 
+enum {
+    VMEM_TEST_THREADS = 4,
+    VMEM_TEST_RINGS = 200,
+};
+
+/// Make & check lots of small rings, to race with other threads doing the same
+static void vmem_ring_worker(void* arg) {
+    _Atomic(u32)* failures = arg;
+    const u8 tag = (u8)(uintptr_t)&tag;
+    for (u32 i = 0; i < VMEM_TEST_RINGS; i++) {
+        volatile u8* ring = vmem_create_repeat_mapping_pages(1, 2);
+        if (ring == NULL) {
+            atomic_fetch_add(failures, 1);
+            continue;
+        }
+        // If another thread's ring shared our backing file, its writes (or
+        // resizing) would show up here
+        ring[0] = tag + (u8)i;
+        thread_yield();
+        if (ring[VMEM_PAGE_SIZE] != (u8)(tag + i)) {
+            atomic_fetch_add(failures, 1);
+        }
+        vmem_destroy_repeat_mapping_pages((void*)ring, 1, 2);
+    }
+}
+
 bool test_vmem() {
     bool result = true;
 
@@ -13,11 +40,14 @@ bool test_vmem() {
     // underlying buffer reflects the change in all views.
     const u32 ring_size = 8 * VMEM_ALLOC_GRANULARITY;
     const u32 ring_count = 5;
-    u8* ringmap = vmem_create_repeat_mapping(8, ring_count);
+    // Volatile, because otherwise the compiler knows these are different
+    // addresses & can read them before the write
+    volatile u8* ringmap = vmem_create_repeat_mapping(8, ring_count);
 
     if (ringmap == NULL) {
         printf("Failed to create ring mapping!\n");
-        result = false;
+        REPORT_RESULT(false);
+        return false;
     }
     ringmap[0] = 20;
 
@@ -27,7 +57,46 @@ bool test_vmem() {
         printf("Ring mapping isn't working!\n");
         result = false;
     }
-    vmem_destroy_repeat_mapping(ringmap, 8, 5);
+    vmem_destroy_repeat_mapping((void*)ringmap, 8, 5);
+
+    // Page-sized rings, as small as the platform allows
+    const u32 granularity = vmem_repeat_granularity();
+    const u32 pages = granularity / VMEM_PAGE_SIZE;
+    volatile u8* small = vmem_create_repeat_mapping_pages(pages, 3);
+    if (small == NULL) {
+        printf("Failed to create a 0x%X byte ring mapping!\n", granularity);
+        result = false;
+    }
+    else {
+        small[granularity - 1] = 7;
+        small[granularity * 2] = 9;
+        if (small[(granularity * 3) - 1] != 7 || small[0] != 9) {
+            printf("Page-sized ring mapping isn't working!\n");
+            result = false;
+        }
+        vmem_destroy_repeat_mapping_pages((void*)small, pages, 3);
+    }
+    if (vmem_create_repeat_mapping_pages(0, 2) != NULL) {
+        printf("Created a ring mapping with no pages!\n");
+        result = false;
+    }
+
+    // Creating rings on several threads at once can't mix up their memory
+    _Atomic(u32) failures = 0;
+    thread threads[VMEM_TEST_THREADS] = {0};
+    for (u32 i = 0; i < ARRAY_SIZE(threads); i++) {
+        if (!thread_create(&threads[i], vmem_ring_worker, (void*)&failures)) {
+            printf("Couldn't start thread!\n");
+            return false;
+        }
+    }
+    for (u32 i = 0; i < ARRAY_SIZE(threads); i++) {
+        thread_join(threads[i]);
+    }
+    if (atomic_load(&failures) != 0) {
+        printf("%u ring mappings failed or shared memory with another thread!\n", atomic_load(&failures));
+        result = false;
+    }
 
     // A 39-bit region is 512 GiB of address space
     const u64 region_size = exponent(2, 39);
@@ -0,0 +1,188 @@
+#include <string.h>
+
+#include <common/logging.h>
+#include <common/int.h>
+#include <common/thread.h>
+#include <common/vfile.h>
+#include <common/vmem.h>
+#include <common/vmem_ring.h>
+
+#include "testing.h"
+
+enum {
+    /// Number of u32s streamed through a 1-page ring, so it wraps many times
+    STREAM_COUNT = 200000,
+    STREAM_TIMEOUT_MS = 20,
+};
+
+typedef struct {
+    vmem_ring* ring;
+    _Atomic(u32)* bad;
+}stream_args;
+
+/// Write counting u32s in odd-sized byte chunks, so values get split across
+/// commits & across the end of the ring
+static void stream_producer(void* arg) {
+    stream_args* args = arg;
+    const u64 total = (u64)STREAM_COUNT * sizeof(u32);
+    u64 written = 0;
+    u32 chunk = 1;
+    while (written < total) {
+        const csize size = (csize)MIN(chunk, total - written);
+        if (!vmem_ring_write_wait(args->ring, size, THREAD_WAIT_FOREVER)) {
+            atomic_fetch_add(args->bad, 1);
+            break;
+        }
+        u8* dst = vmem_ring_write_reserve(args->ring, size);
+        if (dst == NULL) {
+            atomic_fetch_add(args->bad, 1);
+            break;
+        }
+        for (csize i = 0; i < size; i++) {
+            const u64 byte = written + i;
+            const u32 val = (u32)(byte / sizeof(u32));
+            u8 bytes[sizeof(u32)];
+            memcpy(bytes, &val, sizeof(val));
+            dst[i] = bytes[byte % sizeof(u32)];
+        }
+        vmem_ring_write_commit(args->ring, size);
+        written += size;
+        chunk = (chunk * 7 + 3) % 251 + 1;
+    }
+    vmem_ring_close(args->ring);
+}
+
+bool test_vmem_ring() {
+    bool result = true;
+
+    vmem_ring r = vmem_ring_create(1);
+    if (r.data == NULL) {
+        printf("CREATE: Couldn't create a ring!\n");
+        return false;
+    }
+    if (r.size != vmem_repeat_granularity()) {
+        printf("CREATE: Ring size 0x%llX wasn't rounded up to the granularity!\n", (unsigned long long)r.size);
+        result = false;
+    }
+    if (vmem_ring_write_space(&r) != r.size) {
+        printf("CREATE: New ring isn't empty!\n");
+        result = false;
+    }
+    if (vmem_ring_write_reserve(&r, r.size + 1) != NULL) {
+        printf("RESERVE: Reserved more than the ring size!\n");
+        result = false;
+    }
+
+    csize available = 1;
+    vmem_ring_read_peek(&r, &available);
+    if (available != 0) {
+        printf("PEEK: Empty ring has 0x%llX bytes!\n", (unsigned long long)available);
+        result = false;
+    }
+    if (vmem_ring_read_wait(&r, 1, 0)) {
+        printf("WAIT: Zero timeout didn't time out on an empty ring!\n");
+        result = false;
+    }
+    const u64 start = thread_time_ms();
+    if (vmem_ring_read_wait(&r, 1, STREAM_TIMEOUT_MS)) {
+        printf("WAIT: Didn't time out on an empty ring!\n");
+        result = false;
+    }
+    // Clocks can be coarse, so allow a little slack
+    if (thread_time_ms() - start < STREAM_TIMEOUT_MS - 2) {
+        printf("WAIT: Timed out too early!\n");
+        result = false;
+    }
+
+    // Move the positions near the end, so the next write wraps around
+    const csize skip = r.size - 5;
+    vmem_ring_write_reserve(&r, skip);
+    vmem_ring_write_commit(&r, skip);
+    vmem_ring_read_consume(&r, skip);
+
+    // A wrapping write is still one contiguous block
+    u8* dst = vmem_ring_write_reserve(&r, 12);
+    if (dst == NULL) {
+        printf("RESERVE: Couldn't reserve across the end of the ring!\n");
+        return false;
+    }
+    memcpy(dst, "hello, ring!", 12);
+    vmem_ring_write_commit(&r, 12);
+    if (vmem_ring_write_space(&r) != r.size - 12) {
+        printf("COMMIT: Wrong free space after commit!\n");
+        result = false;
+    }
+    if (r.data[0] != ',' || r.data[2] != 'r') {
+        printf("COMMIT: Wrapped bytes didn't land at the start of the ring!\n");
+        result = false;
+    }
+
+    const u8* src = vmem_ring_read_peek(&r, &available);
+    if (available != 12 || memcmp(src, "hello, ring!", 12) != 0) {
+        printf("PEEK: Read back the wrong bytes across the end of the ring!\n");
+        result = false;
+    }
+    vmem_ring_read_consume(&r, 7);
+    src = vmem_ring_read_peek(&r, &available);
+    if (available != 5 || memcmp(src, "ring!", 5) != 0) {
+        printf("CONSUME: Partial consume left the wrong bytes!\n");
+        result = false;
+    }
+
+    // Closing lets the reader drain what's left, then reports EOF
+    vmem_ring_close(&r);
+    if (vmem_ring_read_eof(&r)) {
+        printf("CLOSE: EOF with bytes left!\n");
+        result = false;
+    }
+    if (!vmem_ring_read_wait(&r, 5, THREAD_WAIT_FOREVER) || vmem_ring_read_wait(&r, 6, THREAD_WAIT_FOREVER)) {
+        printf("CLOSE: Wrong wait results on a closed ring!\n");
+        result = false;
+    }
+    vmem_ring_read_consume(&r, 100);
+    if (!vmem_ring_read_eof(&r)) {
+        printf("CLOSE: No EOF on a closed & empty ring!\n");
+        result = false;
+    }
+    vmem_ring_destroy(&r);
+    if (r.data != NULL) {
+        printf("DESTROY: Ring wasn't cleared!\n");
+        result = false;
+    }
+
+    // Stream through a thread & parse the values straight out of the ring
+    r = vmem_ring_create(1);
+    _Atomic(u32) bad = 0;
+    stream_args args = { .ring = &r, .bad = &bad };
+    thread producer = {0};
+    if (!thread_create(&producer, stream_producer, &args)) {
+        printf("THREAD: Couldn't start thread!\n");
+        return false;
+    }
+    u32 expected = 0;
+    while (vmem_ring_read_wait(&r, sizeof(u32), THREAD_WAIT_FOREVER)) {
+        vfile f = vmem_ring_read_vfile(&r);
+        while (f.size - f.pos >= sizeof(u32)) {
+            const u32 val = VFILE_READ(u32, &f);
+            if (val != expected) {
+                atomic_fetch_add(&bad, 1);
+            }
+            expected++;
+        }
+        vmem_ring_read_consume(&r, (csize)f.pos);
+    }
+    thread_join(producer);
+
+    if (atomic_load(&bad) != 0) {
+        printf("THREAD: %u values were wrong or failed to write!\n", atomic_load(&bad));
+        result = false;
+    }
+    if (expected != STREAM_COUNT || !vmem_ring_read_eof(&r)) {
+        printf("THREAD: Read %u of %u values!\n", expected, STREAM_COUNT);
+        result = false;
+    }
+    vmem_ring_destroy(&r);
+
+    REPORT_RESULT(result);
+    return result;
+}